@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Steno keys, numbered in the order of the GeminiPR protocol */
+
+#define STENO_FN 0
+#define STENO_N1 1
+#define STENO_N2 2
+#define STENO_N3 3
+#define STENO_N4 4
+#define STENO_N5 5
+#define STENO_N6 6
+#define STENO_S1 7
+#define STENO_S2 8
+#define STENO_TL 9
+#define STENO_KL 10
+#define STENO_PL 11
+#define STENO_WL 12
+#define STENO_HL 13
+#define STENO_RL 14
+#define STENO_A 15
+#define STENO_O 16
+#define STENO_ST1 17
+#define STENO_ST2 18
+#define STENO_RES1 19
+#define STENO_RES2 20
+#define STENO_PWR 21
+#define STENO_ST3 22
+#define STENO_ST4 23
+#define STENO_E 24
+#define STENO_U 25
+#define STENO_FR 26
+#define STENO_RR 27
+#define STENO_PR 28
+#define STENO_BR 29
+#define STENO_LR 30
+#define STENO_GR 31
+#define STENO_TR 32
+#define STENO_SR 33
+#define STENO_DR 34
+#define STENO_N7 35
+#define STENO_N8 36
+#define STENO_N9 37
+#define STENO_NA 38
+#define STENO_NB 39
+#define STENO_NC 40
+#define STENO_ZR 41
+
+#define STENO_KEYS_LEN 42
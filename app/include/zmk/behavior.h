@@ -18,6 +18,9 @@ struct zmk_behavior_binding {
     zmk_behavior_local_id_t local_id;
 #endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
     const char *behavior_dev;
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+    const struct device *dev;
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
     uint32_t param1;
     uint32_t param2;
 };
@@ -45,6 +48,41 @@ struct zmk_behavior_binding_event {
  */
 const struct device *zmk_behavior_get_binding(const char *name);
 
+/**
+ * @brief Get the behavior device for a binding.
+ *
+ * If the binding carries an already resolved device, that is returned directly. Otherwise this
+ * falls back to looking the behavior up by its @p behavior_dev name.
+ *
+ * @param binding Behavior binding to get the device for.
+ *
+ * @retval Pointer to the device structure for the binding's behavior.
+ * @retval NULL if the behavior is not found or its initialization function failed.
+ */
+static inline const struct device *
+zmk_behavior_get_binding_device(const struct zmk_behavior_binding *binding) {
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+    if (binding->dev) {
+        return binding->dev;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+
+    return zmk_behavior_get_binding(binding->behavior_dev);
+}
+
+/**
+ * @brief Resolve and store the behavior device for a binding, so later invocations of it
+ * don't need to look up the behavior by name.
+ *
+ * Does nothing unless CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS is enabled.
+ *
+ * @param binding Behavior binding to resolve.
+ *
+ * @retval 0 If successful, or the binding has no behavior assigned.
+ * @retval -ENODEV if the named behavior is not found or its initialization function failed.
+ */
+int zmk_behavior_resolve_binding_device(struct zmk_behavior_binding *binding);
+
 /**
  * @brief Invoke a behavior given its binding and invoking event details.
  *
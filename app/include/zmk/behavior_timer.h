@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+struct zmk_behavior_timer;
+
+typedef void (*zmk_behavior_timer_handler_t)(struct zmk_behavior_timer *timer);
+
+/**
+ * A timeout shared with all other behavior timers through a single timer wheel. Embed it in the
+ * state that needs the timeout and use CONTAINER_OF() in the handler to get back to that state.
+ * A zero-initialized timer with its handler set is ready to use.
+ */
+struct zmk_behavior_timer {
+    sys_dnode_t node;
+    int64_t expires_at;
+    zmk_behavior_timer_handler_t handler;
+};
+
+void zmk_behavior_timer_init(struct zmk_behavior_timer *timer,
+                             zmk_behavior_timer_handler_t handler);
+
+/**
+ * Starts the timer so its handler is called from the system work queue once k_uptime_get()
+ * reaches expires_at, replacing any previous expiry. Timers that expire at the same time are
+ * handled in the order they were started.
+ */
+void zmk_behavior_timer_start(struct zmk_behavior_timer *timer, int64_t expires_at);
+
+/**
+ * Stops the timer. Once this returns the handler will not be called, unless the timer is started
+ * again.
+ */
+void zmk_behavior_timer_stop(struct zmk_behavior_timer *timer);
+
+bool zmk_behavior_timer_is_pending(const struct zmk_behavior_timer *timer);
@@ -68,8 +68,26 @@ int zmk_endpoints_toggle_transport(void);
  */
 struct zmk_endpoint_instance zmk_endpoints_selected(void);
 
+/**
+ * Sends the current report for the given usage page. With CONFIG_ZMK_ENDPOINTS_COALESCE_REPORTS,
+ * the report is only marked as pending and sent once the current burst of events has been handled,
+ * together with any other reports changed by that burst.
+ */
 int zmk_endpoints_send_report(uint16_t usage_page);
 
+/**
+ * Must be called before the HID state is changed for a key press or release. With report
+ * coalescing, pending reports are sent first unless they only hold releases and this is another
+ * release, so a key that is pressed and released within one burst of events still reaches the host
+ * and presses reach it in order.
+ */
+void zmk_endpoints_prepare_report_change(bool pressed);
+
+/**
+ * Sends any reports held back by report coalescing right away.
+ */
+int zmk_endpoints_send_pending_reports(void);
+
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_endpoints_send_mouse_report();
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
@@ -9,9 +9,45 @@
 #include <stddef.h>
 #include <zephyr/kernel.h>
 #include <zephyr/types.h>
+#include <zephyr/sys/iterable_sections.h>
+
+struct zmk_event_dispatch_slot;
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+
+#define ZMK_EVENT_MANAGER_STATS_BUCKETS CONFIG_ZMK_EVENT_MANAGER_STATS_HISTOGRAM_BUCKETS
+
+struct zmk_event_type_stats {
+    uint32_t raised;
+    uint32_t captured;
+    uint32_t released;
+    uint32_t reraised;
+    // Bucket 0 counts dispatches under 1us, bucket N those in [2^(N-1), 2^N) us, and the last
+    // bucket everything above.
+    uint32_t histogram[ZMK_EVENT_MANAGER_STATS_BUCKETS];
+};
+
+struct zmk_listener_stats {
+    uint32_t calls;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+
+// Per event type dispatch table, filled in at init from the subscription section so that raising
+// an event only visits the listeners that actually subscribed to its type.
+struct zmk_event_subscribers {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    struct zmk_event_type_stats stats;
+#endif
+    struct zmk_event_dispatch_slot *slots;
+    uint8_t len;
+};
 
 struct zmk_event_type {
     const char *name;
+    struct zmk_event_subscribers *subscribers;
 };
 
 typedef struct {
@@ -26,6 +62,9 @@ typedef struct {
 typedef int (*zmk_listener_callback_t)(const zmk_event_t *eh);
 struct zmk_listener {
     zmk_listener_callback_t callback;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    const char *name;
+#endif
 };
 
 struct zmk_event_subscription {
@@ -33,6 +72,14 @@ struct zmk_event_subscription {
     const struct zmk_listener *listener;
 };
 
+// One RAM slot is reserved per subscription to back the per type dispatch tables.
+struct zmk_event_dispatch_slot {
+    const struct zmk_listener *listener;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    struct zmk_listener_stats stats;
+#endif
+};
+
 #define ZMK_EVENT_DECLARE(event_type)                                                              \
     struct event_type##_event {                                                                    \
         zmk_event_t header;                                                                        \
@@ -44,7 +91,11 @@ struct zmk_event_subscription {
     extern const struct zmk_event_type zmk_event_##event_type;
 
 #define ZMK_EVENT_IMPL(event_type)                                                                 \
-    const struct zmk_event_type zmk_event_##event_type = {.name = STRINGIFY(event_type)};          \
+    static struct zmk_event_subscribers zmk_event_subscribers_##event_type;                        \
+    const struct zmk_event_type zmk_event_##event_type = {                                         \
+        .name = STRINGIFY(event_type),                                                             \
+        .subscribers = &zmk_event_subscribers_##event_type,                                        \
+    };                                                                                             \
     const struct zmk_event_type *zmk_event_ref_##event_type __used                                 \
         __attribute__((__section__(".event_type"))) = &zmk_event_##event_type;                     \
     struct event_type##_event copy_raised_##event_type(const struct event_type *ev) {              \
@@ -61,7 +112,10 @@ struct zmk_event_subscription {
                                                       : NULL;                                      \
     };
 
-#define ZMK_LISTENER(mod, cb) const struct zmk_listener zmk_listener_##mod = {.callback = cb};
+#define ZMK_LISTENER(mod, cb)                                                                      \
+    const struct zmk_listener zmk_listener_##mod = {                                               \
+        .callback = cb,                                                                            \
+        IF_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS, (.name = STRINGIFY(mod), ))};
 
 #define ZMK_SUBSCRIPTION(mod, ev_type)                                                             \
     extern const struct zmk_listener zmk_listener_##mod;                                           \
@@ -70,7 +124,9 @@ struct zmk_event_subscription {
         __attribute__((__section__(".event_subscription"))) = {                                    \
             .event_type = &zmk_event_##ev_type,                                                    \
             .listener = &zmk_listener_##mod,                                                       \
-    };
+    };                                                                                             \
+    static STRUCT_SECTION_ITERABLE(zmk_event_dispatch_slot,                                        \
+                                   _CONCAT(_CONCAT(zmk_event_slot_, mod), ev_type));
 
 #define ZMK_EVENT_RAISE(ev) zmk_event_manager_raise(&(ev).header)
 
@@ -84,4 +140,37 @@ struct zmk_event_subscription {
 int zmk_event_manager_raise(zmk_event_t *event);
 int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener);
 int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *listener);
-int zmk_event_manager_release(zmk_event_t *event);
\ No newline at end of file
+int zmk_event_manager_release(zmk_event_t *event);
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+
+typedef void (*zmk_event_manager_stats_cb)(const struct zmk_event_type *type,
+                                           const struct zmk_event_type_stats *type_stats,
+                                           const struct zmk_listener *listener,
+                                           const struct zmk_listener_stats *listener_stats,
+                                           void *user_data);
+
+/**
+ * @brief Iterate the collected statistics of every (event type, listener) subscription.
+ *
+ * The callback is invoked once per subscription, with the statistics of the event type it belongs
+ * to, so consumers (logging, RPC) can render them however they like.
+ */
+void zmk_event_manager_stats_foreach(zmk_event_manager_stats_cb cb, void *user_data);
+
+/**
+ * @brief Convert a cycle count from the statistics into microseconds.
+ */
+uint32_t zmk_event_manager_stats_cycles_to_us(uint64_t cycles);
+
+/**
+ * @brief Log all the collected event manager statistics.
+ */
+void zmk_event_manager_stats_log(void);
+
+/**
+ * @brief Clear all the collected event manager statistics.
+ */
+void zmk_event_manager_stats_reset(void);
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
@@ -10,6 +10,10 @@
 #include <zmk/event_manager.h>
 #include <zmk/keys.h>
 
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+#include <zmk/latency_probe.h>
+#endif
+
 struct zmk_keycode_state_changed {
     uint16_t usage_page;
     uint32_t keycode;
@@ -17,6 +21,9 @@ struct zmk_keycode_state_changed {
     uint8_t explicit_modifiers;
     bool state;
     int64_t timestamp;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    uint32_t probe_origin;
+#endif
 };
 
 ZMK_EVENT_DECLARE(zmk_keycode_state_changed);
@@ -43,7 +50,11 @@ zmk_keycode_state_changed_from_encoded(uint32_t encoded, bool pressed, int64_t t
                                               .implicit_modifiers = implicit_modifiers,
                                               .explicit_modifiers = explicit_modifiers,
                                               .state = pressed,
-                                              .timestamp = timestamp};
+                                              .timestamp = timestamp,
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+                                              .probe_origin = zmk_latency_probe_get_origin(),
+#endif
+    };
 }
 
 static inline int raise_zmk_keycode_state_changed_from_encoded(uint32_t encoded, bool pressed,
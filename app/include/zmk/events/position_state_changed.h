@@ -16,6 +16,10 @@ struct zmk_position_state_changed {
     uint32_t position;
     bool state;
     int64_t timestamp;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    // Latency probe stamp from when the kscan driver reported the change, zero if unknown.
+    uint32_t probe_origin;
+#endif
 };
 
 ZMK_EVENT_DECLARE(zmk_position_state_changed);
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+struct zmk_steno_stroke {
+    // Bitset of the steno keys in the stroke, indexed by the STENO_* key numbers
+    uint64_t keys;
+    int64_t timestamp;
+};
+
+ZMK_EVENT_DECLARE(zmk_steno_stroke);
@@ -394,3 +394,17 @@ zmk_hid_boot_report_t *zmk_hid_get_boot_report();
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 struct zmk_hid_mouse_report *zmk_hid_get_mouse_report();
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+/**
+ * Whether @p pending, a report still waiting to be sent, can be dropped in favor of @p next, the
+ * report queued after it, without the host missing a key press or release. @p prev is the report
+ * the host got before @p pending.
+ */
+bool zmk_hid_keyboard_report_body_is_skippable(const struct zmk_hid_keyboard_report_body *prev,
+                                               const struct zmk_hid_keyboard_report_body *pending,
+                                               const struct zmk_hid_keyboard_report_body *next);
+bool zmk_hid_consumer_report_body_is_skippable(const struct zmk_hid_consumer_report_body *prev,
+                                               const struct zmk_hid_consumer_report_body *pending,
+                                               const struct zmk_hid_consumer_report_body *next);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
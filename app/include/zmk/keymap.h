@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+
 #include <zmk/events/position_state_changed.h>
 
 #define ZMK_LAYER_CHILD_LEN_PLUS_ONE(node) 1 +
@@ -30,8 +33,150 @@ typedef uint8_t zmk_keymap_layer_id_t;
  */
 typedef uint8_t zmk_keymap_layer_index_t;
 
+/**
+ * @brief A bitset of layer IDs, e.g. the currently active layers.
+ *
+ * Keymaps with up to 32 layers use a plain integer, so existing code treating the state as a
+ * bitmask keeps working. Larger keymaps use an array of words. Use the
+ * zmk_keymap_layers_state_* helpers below to work with either representation.
+ */
+#if ZMK_KEYMAP_LAYERS_LEN <= 32
+
 typedef uint32_t zmk_keymap_layers_state_t;
 
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 1
+
+#else
+
+// Layer IDs are a uint8_t, so we never need more than 8 words. This needs to be a literal for
+// use with LISTIFY.
+#if ZMK_KEYMAP_LAYERS_LEN <= 64
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 2
+#elif ZMK_KEYMAP_LAYERS_LEN <= 96
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 3
+#elif ZMK_KEYMAP_LAYERS_LEN <= 128
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 4
+#elif ZMK_KEYMAP_LAYERS_LEN <= 160
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 5
+#elif ZMK_KEYMAP_LAYERS_LEN <= 192
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 6
+#elif ZMK_KEYMAP_LAYERS_LEN <= 224
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 7
+#else
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 8
+#endif
+
+typedef struct {
+    uint32_t words[ZMK_KEYMAP_LAYERS_STATE_WORDS];
+} zmk_keymap_layers_state_t;
+
+#endif // ZMK_KEYMAP_LAYERS_LEN <= 32
+
+/**
+ * @brief Check if @p layer is set in @p state.
+ */
+static inline bool zmk_keymap_layers_state_test(zmk_keymap_layers_state_t state,
+                                                zmk_keymap_layer_id_t layer) {
+#if ZMK_KEYMAP_LAYERS_STATE_WORDS == 1
+    return (state & BIT(layer)) != 0;
+#else
+    return (state.words[layer / 32] & BIT(layer % 32)) != 0;
+#endif
+}
+
+/**
+ * @brief Set or clear @p layer in @p state.
+ */
+static inline void zmk_keymap_layers_state_write(zmk_keymap_layers_state_t *state,
+                                                 zmk_keymap_layer_id_t layer, bool value) {
+#if ZMK_KEYMAP_LAYERS_STATE_WORDS == 1
+    WRITE_BIT(*state, layer, value);
+#else
+    WRITE_BIT(state->words[layer / 32], layer % 32, value);
+#endif
+}
+
+/**
+ * @brief Check if two layer states have exactly the same layers set.
+ */
+static inline bool zmk_keymap_layers_state_equal(zmk_keymap_layers_state_t a,
+                                                 zmk_keymap_layers_state_t b) {
+#if ZMK_KEYMAP_LAYERS_STATE_WORDS == 1
+    return a == b;
+#else
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        if (a.words[i] != b.words[i]) {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+/**
+ * @brief Check if every layer set in @p mask is also set in @p state.
+ */
+static inline bool zmk_keymap_layers_state_contains(zmk_keymap_layers_state_t state,
+                                                    zmk_keymap_layers_state_t mask) {
+#if ZMK_KEYMAP_LAYERS_STATE_WORDS == 1
+    return (state & mask) == mask;
+#else
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        if ((state.words[i] & mask.words[i]) != mask.words[i]) {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+/**
+ * @brief Find the highest layer ID set in @p state.
+ *
+ * @retval The highest layer ID set.
+ * @retval -1 if no layers are set.
+ */
+static inline int zmk_keymap_layers_state_highest(zmk_keymap_layers_state_t state) {
+#if ZMK_KEYMAP_LAYERS_STATE_WORDS == 1
+    return state ? 31 - __builtin_clz(state) : -1;
+#else
+    for (int i = ZMK_KEYMAP_LAYERS_STATE_WORDS - 1; i >= 0; i--) {
+        if (state.words[i]) {
+            return i * 32 + 31 - __builtin_clz(state.words[i]);
+        }
+    }
+
+    return -1;
+#endif
+}
+
+#define Z_ZMK_KEYMAP_LAYER_BIT(node_id, prop, idx) BIT(DT_PROP_BY_IDX(node_id, prop, idx)) |
+
+#define Z_ZMK_KEYMAP_LAYER_WORD_BIT(node_id, prop, idx, word)                                      \
+    ((DT_PROP_BY_IDX(node_id, prop, idx) / 32 == (word))                                           \
+         ? BIT(DT_PROP_BY_IDX(node_id, prop, idx) % 32)                                            \
+         : 0) |
+
+#define Z_ZMK_KEYMAP_LAYER_WORD(word, node_id, prop)                                               \
+    (DT_FOREACH_PROP_ELEM_VARGS(node_id, prop, Z_ZMK_KEYMAP_LAYER_WORD_BIT, word) 0)
+
+/**
+ * @brief Initializer for a zmk_keymap_layers_state_t with the layers listed in the devicetree
+ * array property @p prop of @p node_id set.
+ */
+#if ZMK_KEYMAP_LAYERS_STATE_WORDS == 1
+#define ZMK_KEYMAP_LAYERS_STATE_DT_PROP(node_id, prop)                                             \
+    (DT_FOREACH_PROP_ELEM(node_id, prop, Z_ZMK_KEYMAP_LAYER_BIT) 0)
+#else
+#define ZMK_KEYMAP_LAYERS_STATE_DT_PROP(node_id, prop)                                             \
+    {                                                                                              \
+        .words = {LISTIFY(ZMK_KEYMAP_LAYERS_STATE_WORDS, Z_ZMK_KEYMAP_LAYER_WORD, (, ), node_id,    \
+                          prop)}                                                                   \
+    }
+#endif
+
 zmk_keymap_layer_id_t zmk_keymap_layer_index_to_id(zmk_keymap_layer_index_t layer_index);
 
 zmk_keymap_layer_id_t zmk_keymap_layer_default(void);
@@ -44,8 +189,28 @@ int zmk_keymap_layer_toggle(zmk_keymap_layer_id_t layer);
 int zmk_keymap_layer_to(zmk_keymap_layer_id_t layer);
 const char *zmk_keymap_layer_name(zmk_keymap_layer_id_t layer);
 
+#if !IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
+/**
+ * @brief Get a pointer to the stored binding at @p binding_idx of @p layer.
+ *
+ * @note Not available with CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS, since full bindings aren't stored.
+ * Use zmk_keymap_read_layer_binding_at_idx() instead. With CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS,
+ * the returned pointer is only valid until the keymap is next edited.
+ */
 const struct zmk_behavior_binding *zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer,
                                                                        uint8_t binding_idx);
+
+#endif // !IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
+/**
+ * @brief Copy the binding at @p binding_idx of @p layer into @p binding.
+ *
+ * @retval 0 If successful.
+ * @retval Negative errno code if the layer or binding index is invalid.
+ */
+int zmk_keymap_read_layer_binding_at_idx(zmk_keymap_layer_id_t layer, uint8_t binding_idx,
+                                         struct zmk_behavior_binding *binding);
 int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer, uint8_t binding_idx,
                                         const struct zmk_behavior_binding binding);
 
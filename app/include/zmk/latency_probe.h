@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <zmk/endpoints_types.h>
+
+/**
+ * Aggregated keypress to report latency for a single transport.
+ */
+struct zmk_latency_probe_stats {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t avg_us;
+    // Upper bound of the histogram bucket containing the 99th percentile sample.
+    uint32_t p99_us;
+};
+
+/**
+ * @brief Get a probe origin stamp for a key event entering ZMK right now.
+ *
+ * Origins are cycle counter values, with zero reserved to mean "no origin".
+ */
+uint32_t zmk_latency_probe_stamp(void);
+
+/**
+ * @brief Set the origin of the key event currently being processed, returning the previous one
+ * so callers can restore it when they're done.
+ */
+uint32_t zmk_latency_probe_set_origin(uint32_t origin);
+
+/**
+ * @brief Get the origin of the key event currently being processed, or zero if none.
+ */
+uint32_t zmk_latency_probe_get_origin(void);
+
+/**
+ * @brief Record that a report caused by the key event with @p origin just left on @p transport .
+ *
+ * Only the first report sent for a given origin is counted.
+ */
+void zmk_latency_probe_record(enum zmk_transport transport, uint32_t origin);
+
+int zmk_latency_probe_get_stats(enum zmk_transport transport,
+                                struct zmk_latency_probe_stats *stats);
+
+void zmk_latency_probe_log(void);
+
+void zmk_latency_probe_reset(void);
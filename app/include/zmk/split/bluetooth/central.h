@@ -3,11 +3,29 @@
 
 #include <zephyr/bluetooth/addr.h>
 #include <zmk/behavior.h>
+#include <zmk/split/bluetooth/conn_params.h>
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 #include <zmk/hid_indicators_types.h>
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
+enum zmk_split_central_event_type {
+    ZMK_SPLIT_CENTRAL_EVENT_POSITION,
+    ZMK_SPLIT_CENTRAL_EVENT_SENSOR,
+    ZMK_SPLIT_CENTRAL_EVENT_INPUT,
+    ZMK_SPLIT_CENTRAL_EVENT_BATTERY,
+    ZMK_SPLIT_CENTRAL_EVENT_TYPE_COUNT,
+};
+
+/**
+ * Gets how many events of the given type were dropped since boot, because they arrived from the
+ * peripherals faster than they could be raised.
+ */
+int zmk_split_bt_central_get_event_drops(enum zmk_split_central_event_type type,
+                                         uint32_t *drops);
+
+int zmk_split_bt_central_get_conn_params(uint8_t source, struct zmk_split_bt_conn_params *params);
+
 int zmk_split_bt_invoke_behavior(uint8_t source, struct zmk_behavior_binding *binding,
                                  struct zmk_behavior_binding_event event, bool state);
 
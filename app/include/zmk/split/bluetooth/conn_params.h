@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/types.h>
+
+#include <zmk/activity.h>
+
+struct zmk_split_bt_conn_params {
+    // In units of 1.25 ms.
+    uint16_t interval;
+    uint16_t latency;
+    // In units of 10 ms.
+    uint16_t timeout;
+    // How often the parameters changed after connecting, since boot.
+    uint32_t updates;
+};
+
+// The connection parameters split links are asked to use while the keyboard is active, and while
+// it is idle or asleep.
+struct zmk_split_conn_param_policy {
+    uint16_t active_interval;
+    uint16_t active_latency;
+    uint16_t idle_interval;
+    uint16_t idle_latency;
+};
+
+/**
+ * Picks the interval and latency the policy wants in the given activity state, and returns
+ * whether a link currently using the given parameters has to be asked to switch to them.
+ */
+bool zmk_split_conn_params_update_needed(const struct zmk_split_conn_param_policy *policy,
+                                         enum zmk_activity_state state,
+                                         const struct zmk_split_bt_conn_params *current,
+                                         uint16_t *interval, uint16_t *latency);
+
+/**
+ * Records the parameters a link switched to after connecting.
+ */
+void zmk_split_conn_params_updated(struct zmk_split_bt_conn_params *params, uint16_t interval,
+                                   uint16_t latency, uint16_t timeout);
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/types.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/toolchain.h>
+
+// A ring of fixed size events with a single producer and a single consumer, so it needs no lock.
+// Both indexes count up to twice the size, which tells a full ring apart from an empty one.
+struct zmk_split_event_ring {
+    uint8_t *events;
+    size_t event_size;
+    size_t size;
+    atomic_t head;
+    atomic_t tail;
+    // How many events were dropped because the ring was full, by the type the producer gave them.
+    atomic_t *drops;
+    size_t drop_types;
+    // How many slots only events of the reserved type may take, so other events can't crowd them
+    // out.
+    size_t reserved;
+    size_t reserved_type;
+};
+
+#define ZMK_SPLIT_EVENT_RING_DEFINE_RESERVED(name, event_type, ring_size, num_drop_types,          \
+                                             reserved_slots, reserved_for_type)                    \
+    BUILD_ASSERT(reserved_slots <= ring_size, "More slots reserved than the ring has");            \
+    static event_type _CONCAT(name, _events)[ring_size];                                           \
+    static atomic_t _CONCAT(name, _drops)[num_drop_types];                                         \
+    static struct zmk_split_event_ring name = {                                                    \
+        .events = (uint8_t *)_CONCAT(name, _events),                                               \
+        .event_size = sizeof(event_type),                                                          \
+        .size = ring_size,                                                                         \
+        .drops = _CONCAT(name, _drops),                                                            \
+        .drop_types = num_drop_types,                                                              \
+        .reserved = reserved_slots,                                                                \
+        .reserved_type = reserved_for_type,                                                        \
+    }
+
+#define ZMK_SPLIT_EVENT_RING_DEFINE(name, event_type, ring_size, num_drop_types)                   \
+    ZMK_SPLIT_EVENT_RING_DEFINE_RESERVED(name, event_type, ring_size, num_drop_types, 0, 0)
+
+/**
+ * Copies an event into the ring. Returns -ENOMEM and counts a drop of the given type if the ring
+ * is full, or if only reserved slots are left and the type is not the reserved one. Only to be
+ * called by the producer.
+ */
+int zmk_split_event_ring_put(struct zmk_split_event_ring *ring, const void *event, size_t type);
+
+/**
+ * Copies the oldest event out of the ring and frees its slot. Returns -ENOENT if the ring is
+ * empty. Only to be called by the consumer.
+ */
+int zmk_split_event_ring_get(struct zmk_split_event_ring *ring, void *event);
+
+/**
+ * Returns how many events of the given type were dropped because the ring was full.
+ */
+uint32_t zmk_split_event_ring_get_drops(struct zmk_split_event_ring *ring, size_t type);
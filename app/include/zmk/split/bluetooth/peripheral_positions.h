@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/types.h>
+
+#include <zmk/split/bluetooth/service.h>
+
+// Maps the 16 bit millisecond timestamps a peripheral sends with its position changes to central
+// uptime. The offset between both clocks is taken from the changes that arrived fastest, which are
+// the ones sent in the first connection event after they happened.
+struct zmk_split_peripheral_clock {
+    int64_t window_start;
+    uint16_t window_min[2];
+    uint8_t windows;
+};
+
+/**
+ * Returns the central uptime at which a change happened, from the peripheral timestamp it was
+ * sent with and the central uptime at which it arrived.
+ */
+int64_t zmk_split_peripheral_clock_to_uptime(struct zmk_split_peripheral_clock *clock, int64_t now,
+                                             uint16_t timestamp);
+
+// Tracks which positions of a peripheral are pressed, from the position states and position events
+// it sends, and reports every position whose state changed.
+struct zmk_split_peripheral_positions {
+    // A bitmap of the pressed positions, a whole number of 32 bit words long.
+    uint8_t *state;
+    size_t state_len;
+    struct zmk_split_peripheral_clock clock;
+    int64_t last_timestamp;
+    bool has_event_sequence;
+    uint16_t next_event_sequence;
+};
+
+typedef void (*zmk_split_position_changed_cb)(uint32_t position, bool pressed, int64_t timestamp,
+                                              void *user_data);
+
+void zmk_split_peripheral_positions_init(struct zmk_split_peripheral_positions *positions,
+                                         uint8_t *state, size_t state_len);
+
+/**
+ * Starts over with the clock and event sequence of a new connection. The position state is kept,
+ * so release all positions first.
+ */
+void zmk_split_peripheral_positions_reset(struct zmk_split_peripheral_positions *positions);
+
+/**
+ * Sets the state of all positions from a bitmap of state_len bytes, calling changed for each
+ * position whose state differs, in position order.
+ */
+void zmk_split_peripheral_positions_set_state(struct zmk_split_peripheral_positions *positions,
+                                              const uint8_t *state, int64_t timestamp,
+                                              zmk_split_position_changed_cb changed,
+                                              void *user_data);
+
+/**
+ * Applies the first count events of a position events notification that arrived at now, calling
+ * changed for each of them. Events that repeat a position's current state are skipped, such as
+ * events that were still on their way when the full state was read.
+ *
+ * Returns how many events were lost before this notification, in which case the full position
+ * state has to be read to catch up.
+ */
+uint16_t zmk_split_peripheral_positions_apply_events(
+    struct zmk_split_peripheral_positions *positions,
+    const struct zmk_split_position_events_payload *payload, size_t count, int64_t now,
+    zmk_split_position_changed_cb changed, void *user_data);
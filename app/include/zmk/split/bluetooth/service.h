@@ -6,10 +6,23 @@
 
 #pragma once
 
+#include <zephyr/sys/util.h>
+
 #include <zmk/events/sensor_event.h>
 #include <zmk/sensors.h>
 
 #define ZMK_SPLIT_RUN_BEHAVIOR_DEV_LEN 9
+// The position state is a bitmap of the peripheral's positions, but never shorter than the 16
+// bytes older centrals expect.
+#define ZMK_SPLIT_POS_STATE_MIN_LEN 16
+#define ZMK_SPLIT_POS_STATE_LEN(num_of_positions)                                                  \
+    MAX(ZMK_SPLIT_POS_STATE_MIN_LEN, DIV_ROUND_UP(num_of_positions, 8))
+
+// The most position events in one notification, chosen so that it fits the 20 bytes a
+// notification can carry with the default ATT MTU.
+#define ZMK_SPLIT_POS_EVENTS_MAX 5
+#define ZMK_SPLIT_POS_EVENT_POSITION_MASK BIT_MASK(15)
+#define ZMK_SPLIT_POS_EVENT_PRESSED BIT(15)
 
 struct sensor_event {
     uint8_t sensor_index;
@@ -18,6 +31,32 @@ struct sensor_event {
     struct zmk_sensor_channel_data channel_data[ZMK_SENSOR_EVENT_MAX_CHANNELS];
 } __packed;
 
+// Position state notifications hold the ZMK_SPLIT_POS_STATE_LEN() bytes of the position state,
+// sized by the number of positions in the run behavior characteristic's Number of Digitals
+// descriptor. They are followed by the peripheral's uptime in milliseconds when the change
+// happened, truncated to 16 bits and little endian. Centrals that don't know about it only read
+// the position state.
+#define ZMK_SPLIT_POS_STATE_TIMESTAMP_LEN sizeof(uint16_t)
+
+struct zmk_split_position_event {
+    // The position in the lower 15 bits, with ZMK_SPLIT_POS_EVENT_PRESSED set for a press. Little
+    // endian.
+    uint16_t position;
+    // Milliseconds since the timestamp of the notification.
+    uint8_t time_offset;
+} __packed;
+
+// A notification holds as many events as fit in its length, in the order they happened.
+struct zmk_split_position_events_payload {
+    // The sequence number of the first event. Each following event has the next number, so the
+    // central can tell when events were lost. Little endian.
+    uint16_t sequence;
+    // The peripheral's uptime in milliseconds when the first event happened, truncated to 16 bits.
+    // Little endian.
+    uint16_t timestamp;
+    struct zmk_split_position_event events[ZMK_SPLIT_POS_EVENTS_MAX];
+} __packed;
+
 struct zmk_split_run_behavior_data {
     uint8_t position;
     uint8_t source;
@@ -38,8 +77,8 @@ struct zmk_split_input_event_payload {
     uint8_t sync;
 } __packed;
 
-int zmk_split_bt_position_pressed(uint8_t position);
-int zmk_split_bt_position_released(uint8_t position);
+int zmk_split_bt_position_pressed(uint32_t position, int64_t timestamp);
+int zmk_split_bt_position_released(uint32_t position, int64_t timestamp);
 int zmk_split_bt_sensor_triggered(uint8_t sensor_index,
                                   const struct zmk_sensor_channel_data channel_data[],
                                   size_t channel_data_size);
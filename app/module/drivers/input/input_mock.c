@@ -17,6 +17,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 struct input_mock_config {
     uint16_t startup_delay;
     uint16_t event_period;
+    uint32_t repeat;
     bool exit_after;
     const uint32_t *events;
     size_t events_len;
@@ -24,6 +25,7 @@ struct input_mock_config {
 
 struct input_mock_data {
     size_t event_index;
+    uint32_t repeats_done;
     struct k_work_delayable work;
     const struct device *dev;
 };
@@ -40,6 +42,12 @@ static void input_mock_work_cb(struct k_work *work) {
 
     size_t base_idx = data->event_index * 4;
 
+    if (base_idx >= cfg->events_len && data->repeats_done < cfg->repeat) {
+        data->repeats_done++;
+        data->event_index = 0;
+        base_idx = 0;
+    }
+
     if (base_idx >= cfg->events_len) {
         if (cfg->exit_after) {
             exit(0);
@@ -76,6 +84,7 @@ int input_mock_init(const struct device *dev) {
         .events_len = DT_INST_PROP_LEN(n, events),                                                 \
         .startup_delay = DT_INST_PROP(n, event_startup_delay),                                     \
         .event_period = DT_INST_PROP(n, event_period),                                             \
+        .repeat = DT_INST_PROP(n, repeat),                                                         \
         .exit_after = DT_INST_PROP(n, exit_after),                                                 \
     };                                                                                             \
     DEVICE_DT_INST_DEFINE(n, input_mock_init, NULL, &input_mock_data_##n, &input_mock_cfg_##n,     \
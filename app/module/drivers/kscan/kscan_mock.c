@@ -16,10 +16,96 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <dt-bindings/zmk/kscan_mock.h>
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_RUNTIME_EVENTS)
+
+#include <stdio.h>
+
+#include "cmdline.h"
+#include "soc.h"
+
+// When set, the events in this file replace the ones from the devicetree, so a single build can
+// run any number of scripted event sequences against the same keymap.
+static char *runtime_events_path;
+static uint32_t runtime_events[CONFIG_ZMK_KSCAN_MOCK_RUNTIME_EVENTS_MAX];
+static uint32_t runtime_events_len;
+static bool runtime_events_loaded;
+
+static void kscan_mock_native_posix_options(void) {
+    static struct args_struct_t options[] = {
+        {.option = "kscan_mock_events",
+         .name = "path",
+         .type = 's',
+         .dest = (void *)&runtime_events_path,
+         .descript = "File of whitespace separated ZMK_MOCK_PRESS/ZMK_MOCK_RELEASE values to use "
+                     "instead of the events from the devicetree"},
+        ARG_TABLE_ENDMARKER};
+
+    native_add_command_line_opts(options);
+}
+
+NATIVE_TASK(kscan_mock_native_posix_options, PRE_BOOT_1, 1);
+
+static int kscan_mock_load_runtime_events(void) {
+    if (runtime_events_path == NULL || runtime_events_loaded) {
+        return 0;
+    }
+
+    FILE *file = fopen(runtime_events_path, "r");
+    if (file == NULL) {
+        LOG_ERR("Failed to open mock events file %s", runtime_events_path);
+        return -ENOENT;
+    }
+
+    int ret = 0;
+    long long ev;
+    while (fscanf(file, "%lli", &ev) == 1) {
+        if (runtime_events_len >= ARRAY_SIZE(runtime_events)) {
+            LOG_ERR("More than %d mock events in %s", CONFIG_ZMK_KSCAN_MOCK_RUNTIME_EVENTS_MAX,
+                    runtime_events_path);
+            ret = -ENOMEM;
+            break;
+        }
+
+        runtime_events[runtime_events_len++] = (uint32_t)ev;
+    }
+
+    if (ret == 0 && !feof(file)) {
+        LOG_ERR("Invalid mock event in %s", runtime_events_path);
+        ret = -EINVAL;
+    }
+
+    fclose(file);
+    runtime_events_loaded = true;
+    return ret;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_RUNTIME_EVENTS)
+
+static uint32_t kscan_mock_events_len(uint32_t dt_events_len) {
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_RUNTIME_EVENTS)
+    if (runtime_events_path != NULL) {
+        return runtime_events_len;
+    }
+#endif
+
+    return dt_events_len;
+}
+
+static uint32_t kscan_mock_event(const uint32_t *dt_events, uint32_t index) {
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_RUNTIME_EVENTS)
+    if (runtime_events_path != NULL) {
+        return runtime_events[index];
+    }
+#endif
+
+    return dt_events[index];
+}
+
 struct kscan_mock_data {
     kscan_callback_t callback;
 
     uint32_t event_index;
+    uint32_t repeats_done;
     struct k_work_delayable work;
     const struct device *dev;
 };
@@ -39,6 +125,7 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
     }
 
     data->event_index = 0;
+    data->repeats_done = 0;
     data->callback = callback;
 
     return 0;
@@ -47,13 +134,14 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
 #define MOCK_INST_INIT(n)                                                                          \
     struct kscan_mock_config_##n {                                                                 \
         uint32_t events[DT_INST_PROP_LEN(n, events)];                                              \
+        uint32_t repeat;                                                                           \
         bool exit_after;                                                                           \
     };                                                                                             \
     static void kscan_mock_schedule_next_event_##n(const struct device *dev) {                     \
         struct kscan_mock_data *data = dev->data;                                                  \
         const struct kscan_mock_config_##n *cfg = dev->config;                                     \
-        if (data->event_index < DT_INST_PROP_LEN(n, events)) {                                     \
-            uint32_t ev = cfg->events[data->event_index];                                          \
+        if (data->event_index < kscan_mock_events_len(DT_INST_PROP_LEN(n, events))) {              \
+            uint32_t ev = kscan_mock_event(cfg->events, data->event_index);                        \
             LOG_DBG("delaying next keypress: %d", ZMK_MOCK_MSEC(ev));                              \
             k_work_schedule(&data->work, K_MSEC(ZMK_MOCK_MSEC(ev)));                               \
         } else if (cfg->exit_after) {                                                              \
@@ -65,13 +153,16 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
         struct k_work_delayable *d_work = k_work_delayable_from_work(work);                        \
         struct kscan_mock_data *data = CONTAINER_OF(d_work, struct kscan_mock_data, work);         \
         const struct kscan_mock_config_##n *cfg = data->dev->config;                               \
-        if (data->event_index >= DT_INST_PROP_LEN(n, events)) {                                    \
-            if (cfg->exit_after)                                                                   \
+        if (data->event_index >= kscan_mock_events_len(DT_INST_PROP_LEN(n, events))) {             \
+            if (data->repeats_done < cfg->repeat) {                                                \
+                data->repeats_done++;                                                              \
+                data->event_index = 0;                                                             \
+            } else if (cfg->exit_after)                                                            \
                 exit(0);                                                                           \
             else                                                                                   \
                 return;                                                                            \
         }                                                                                          \
-        uint32_t ev = cfg->events[data->event_index];                                              \
+        uint32_t ev = kscan_mock_event(cfg->events, data->event_index);                            \
         LOG_DBG("ev %u row %d column %d state %d\n", ev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev),       \
                 ZMK_MOCK_IS_PRESS(ev));                                                            \
         data->callback(data->dev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev), ZMK_MOCK_IS_PRESS(ev));      \
@@ -82,7 +173,8 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
         struct kscan_mock_data *data = dev->data;                                                  \
         data->dev = dev;                                                                           \
         k_work_init_delayable(&data->work, kscan_mock_work_handler_##n);                           \
-        return 0;                                                                                  \
+        COND_CODE_1(IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_RUNTIME_EVENTS),                              \
+                    (return kscan_mock_load_runtime_events();), (return 0;))                       \
     }                                                                                              \
     static int kscan_mock_enable_callback_##n(const struct device *dev) {                          \
         kscan_mock_schedule_next_event_##n(dev);                                                   \
@@ -95,7 +187,9 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
     };                                                                                             \
     static struct kscan_mock_data kscan_mock_data_##n;                                             \
     static const struct kscan_mock_config_##n kscan_mock_config_##n = {                            \
-        .events = DT_INST_PROP(n, events), .exit_after = DT_INST_PROP(n, exit_after)};             \
+        .events = DT_INST_PROP(n, events),                                                         \
+        .repeat = DT_INST_PROP(n, repeat),                                                         \
+        .exit_after = DT_INST_PROP(n, exit_after)};                                                \
     DEVICE_DT_INST_DEFINE(n, kscan_mock_init_##n, NULL, &kscan_mock_data_##n,                      \
                           &kscan_mock_config_##n, POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY,         \
                           &mock_driver_api_##n);
@@ -0,0 +1,61 @@
+#!/bin/sh
+
+# Copyright (c) 2024 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+##
+# Optional environment variables, paths can be absolute or relative to $(pwd):
+#  ZMK_SRC_DIR:             Path to zmk/app (default is ./)
+#  ZMK_BUILD_DIR:           Path to build directory (default is $ZMK_SRC_DIR/build)
+#  ZMK_EXTRA_MODULES:       Path to at most one module (in addition to any in west.yml)
+#  ZMK_BENCHMARKS_VERBOSE:  Be more verbose
+#
+# Benchmarks are run one at a time so that their CPU time measurements don't compete.
+
+if [ -z "$1" ]; then
+    echo "Usage: ./run-benchmark.sh <path to benchmark>"
+    exit 1
+fi
+
+path="$1"
+if [ $path = "all" ]; then
+    path="${ZMK_SRC_DIR-.}/benchmarks"
+fi
+
+ZMK_BUILD_DIR=${ZMK_BUILD_DIR:-${ZMK_SRC_DIR:-.}/build}
+mkdir -p ${ZMK_BUILD_DIR}/benchmarks
+
+benchmarks=$(find $path -name native_posix_64.keymap -exec dirname \{\} \; | sort)
+num_cases=$(echo "$benchmarks" | wc -l)
+if [ $num_cases -gt 1 ] || [ "$benchmarks" != "$path" ]; then
+    err=0
+    for benchmark in $benchmarks; do
+        ${0} $benchmark || err=1
+    done
+    exit $err
+fi
+
+benchmark=$(realpath $path | sed -n -e "s|.*/benchmarks/||p")
+echo "Running $benchmark:"
+
+build_cmd="west build ${ZMK_SRC_DIR:+-s $ZMK_SRC_DIR} -d ${ZMK_BUILD_DIR}/benchmarks/$benchmark \
+    -b native_posix_64 -p -- -DZMK_CONFIG="$(realpath $path)" \
+    -DEXTRA_CONF_FILE="$(realpath ${ZMK_SRC_DIR:-.}/benchmarks/benchmark.conf)" \
+    ${ZMK_EXTRA_MODULES:+-DZMK_EXTRA_MODULES="$(realpath ${ZMK_EXTRA_MODULES})"}"
+
+if [ -z ${ZMK_BENCHMARKS_VERBOSE} ]; then
+    $build_cmd >/dev/null 2>&1
+else
+    $build_cmd
+fi
+
+if [ $? -gt 0 ]; then
+    echo "FAILED: $benchmark did not build"
+    exit 1
+fi
+
+${ZMK_BUILD_DIR}/benchmarks/$benchmark/zephyr/zmk.exe |
+    sed -n -e "s/.*BENCHMARK: /  /p" |
+    tee ${ZMK_BUILD_DIR}/benchmarks/$benchmark/benchmark.log
+
+exit 0
@@ -10,7 +10,7 @@
 #  ZMK_EXTRA_MODULES:       Path to at most one module (in addition to any in west.yml)
 #  ZMK_TESTS_VERBOSE:       Be more verbose
 #  ZMK_TESTS_AUTO_ACCEPT:   Replace snapshot files with new key events
-#  J:                       Number of parallel jobs (default is 4)
+#  J:                       Number of parallel jobs (default is the number of CPUs)
 
 if [ -z "$1" ]; then
     echo "Usage: ./run-test.sh <path to testcase>"
@@ -29,7 +29,7 @@ testcases=$(find $path -name native_posix_64.keymap -exec dirname \{\} \;)
 num_cases=$(echo "$testcases" | wc -l)
 if [ $num_cases -gt 1 ] || [ "$testcases" != "$path" ]; then
     echo "" >${ZMK_BUILD_DIR}/tests/pass-fail.log
-    echo "$testcases" | xargs -L 1 -P ${J:-4} ${0}
+    echo "$testcases" | xargs -L 1 -P ${J:-$(nproc)} ${0}
     err=$?
     sort -k2 ${ZMK_BUILD_DIR}/tests/pass-fail.log
     exit $err
@@ -38,8 +38,11 @@ fi
 testcase=$(realpath $path | sed -n -e "s|.*/tests/||p")
 echo "Running $testcase:"
 
+# Tests don't slow down to real time, so the simulated clock skips straight to the next mock event
+# or timeout. This keeps them fast and makes every run see exactly the same timestamps.
 build_cmd="west build ${ZMK_SRC_DIR:+-s $ZMK_SRC_DIR} -d ${ZMK_BUILD_DIR}/tests/$testcase \
-    -b native_posix_64 -p -- -DCONFIG_ASSERT=y -DZMK_CONFIG="$(realpath $path)" \
+    -b native_posix_64 -p auto -- -DCONFIG_ASSERT=y -DCONFIG_NATIVE_POSIX_SLOWDOWN_TO_REAL_TIME=n \
+    -DZMK_CONFIG="$(realpath $path)" \
     ${ZMK_EXTRA_MODULES:+-DZMK_EXTRA_MODULES="$(realpath ${ZMK_EXTRA_MODULES})"}"
 
 if [ -z ${ZMK_TESTS_VERBOSE} ]; then
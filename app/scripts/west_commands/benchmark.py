@@ -0,0 +1,42 @@
+# Copyright (c) 2024 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""Benchmark runner for ZMK."""
+
+import subprocess
+from pathlib import Path
+
+from west import log  # use this for user output
+from west.commands import WestCommand
+
+
+class Benchmark(WestCommand):
+    def __init__(self):
+        super().__init__(
+            name="benchmark",
+            help="run ZMK benchmarks",
+            description="Run the ZMK benchmarks on native_posix_64.",
+        )
+
+        self.appdir = Path(__file__).resolve().parents[2]
+
+    def do_add_parser(self, parser_adder):
+        parser = parser_adder.add_parser(
+            self.name,
+            help=self.help,
+            description=self.description,
+        )
+
+        parser.add_argument(
+            "benchmark_path",
+            default="all",
+            help='The path to the benchmark. Defaults to "all".',
+            nargs="?",
+        )
+        return parser
+
+    def do_run(self, args, unknown_args):
+        # the run-benchmark script assumes the app directory is the current dir.
+        completed_process = subprocess.run(
+            ["./run-benchmark.sh", args.benchmark_path], cwd=self.appdir
+        )
+        exit(completed_process.returncode)
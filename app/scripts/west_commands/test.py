@@ -2,12 +2,171 @@
 # SPDX-License-Identifier: MIT
 """Test runner for ZMK."""
 
+import argparse
+import difflib
+import hashlib
+import os
+import re
+import shutil
 import subprocess
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field
 from pathlib import Path
+from typing import Optional
 
 from west import log  # use this for user output
 from west.commands import WestCommand
 
+BOARD = "native_posix_64"
+
+# Files a test case may contain. Cases with anything else are always built on their own, since
+# there is no telling how the extra files affect the build.
+CASE_FILES = {
+    f"{BOARD}.keymap",
+    f"{BOARD}.conf",
+    "events.patterns",
+    "keycode_events.snapshot",
+    "pending",
+}
+
+BUILD_ARGS = [
+    "-DCONFIG_ASSERT=y",
+    # The simulated clock skips straight to the next mock event or timeout.
+    "-DCONFIG_NATIVE_POSIX_SLOWDOWN_TO_REAL_TIME=n",
+]
+
+# Directories with this file are ztest suites, which are Zephyr apps of their own. They pass if all
+# of their tests do, rather than by comparing a snapshot.
+UNIT_TEST_SUITE_FILE = "testcase.yaml"
+
+# The simulated clock makes even long timeouts finish instantly, so a case that runs this long is
+# stuck, e.g. because its mock kscan never started.
+CASE_TIMEOUT_SECONDS = 60
+
+COMMENT_RE = re.compile(r"/\*.*?\*/|//[^\n]*", re.DOTALL)
+INCLUDE_RE = re.compile(r'^\s*#\s*include\s+"([^"]+)"', re.MULTILINE)
+KSCAN_EVENTS_RE = re.compile(r"\bevents\s*=\s*<([^>]*)>\s*;")
+MOCK_EVENT_RE = re.compile(
+    r"ZMK_MOCK_(PRESS|RELEASE)\(\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*\)"
+)
+
+
+@dataclass
+class TestCase:
+    path: Path
+    name: str
+    # The mock kscan events, encoded the same way as ZMK_MOCK_PRESS/ZMK_MOCK_RELEASE, or None if
+    # they can't be loaded at runtime and the case needs its own build.
+    events: Optional[list] = None
+    # Cases with the same build key compile to the same binary, apart from their events.
+    build_key: Optional[str] = None
+    unit: bool = False
+
+
+@dataclass
+class BuildGroup:
+    build_dir: Path
+    cases: list = field(default_factory=list)
+    runtime_events: bool = True
+
+
+def encode_mock_event(kind: str, row: int, col: int, msec: int) -> int:
+    value = row + (col << 8) + (msec << 16)
+    if kind == "PRESS":
+        value += 1 << 31
+    return value
+
+
+def parse_mock_events(text: str) -> Optional[list]:
+    """Returns the encoded events if the events cell holds nothing but literal mock events."""
+    if MOCK_EVENT_RE.sub("", text).strip():
+        return None
+
+    events = []
+    for kind, row, col, msec in MOCK_EVENT_RE.findall(text):
+        row, col, msec = int(row), int(col), int(msec)
+        if row > 0xFF or col > 0xFF or msec > 0x7FFF:
+            return None
+        events.append(encode_mock_event(kind, row, col, msec))
+
+    return events
+
+
+def read_sources(path: Path, seen: set) -> Optional[str]:
+    """Returns the source of path with its quoted includes, or None if one can't be found."""
+    path = path.resolve()
+    if path in seen:
+        return ""
+    seen.add(path)
+
+    try:
+        text = path.read_text()
+    except OSError:
+        return None
+
+    parts = [text]
+    for include in INCLUDE_RE.findall(COMMENT_RE.sub("", text)):
+        included = read_sources(path.parent / include, seen)
+        if included is None:
+            return None
+        parts.append(f"\n// {include}\n{included}")
+
+    return "".join(parts)
+
+
+def load_test_case(path: Path, tests_dir: Path) -> TestCase:
+    case = TestCase(path=path, name=path.resolve().relative_to(tests_dir).as_posix())
+
+    if any(f.name not in CASE_FILES for f in path.iterdir()):
+        return case
+
+    keymap = COMMENT_RE.sub("", (path / f"{BOARD}.keymap").read_text())
+    matches = KSCAN_EVENTS_RE.findall(keymap)
+    if len(matches) != 1:
+        return case
+
+    events = parse_mock_events(matches[0])
+    if not events:
+        return case
+
+    # Every case in a group is built from the keymap of its first case, so the events property
+    # has to stay in place. Only its contents are left out of the key.
+    sources = read_sources(path / f"{BOARD}.keymap", set())
+    if sources is None:
+        return case
+
+    key = hashlib.sha256()
+    sources = KSCAN_EVENTS_RE.sub("events = <>;", COMMENT_RE.sub("", sources))
+    key.update(" ".join(sources.split()).encode())
+    conf = path / f"{BOARD}.conf"
+    if conf.exists():
+        key.update(b"\0conf\0")
+        key.update(conf.read_bytes())
+
+    case.events = events
+    case.build_key = key.hexdigest()
+    return case
+
+
+def snapshot_lines(text: str) -> list:
+    """Split a snapshot into lines the way `diff -Z` compares them, ignoring trailing
+    whitespace and whether the last line ends with a newline."""
+    return [line.rstrip() for line in text.splitlines()]
+
+
+def find_test_cases(path: Path, tests_dir: Path) -> list:
+    keymaps = [path / f"{BOARD}.keymap"] if path.is_file() else []
+    if not keymaps:
+        keymaps = sorted(path.rglob(f"{BOARD}.keymap"))
+    cases = [load_test_case(keymap.parent, tests_dir) for keymap in keymaps]
+
+    if path.is_dir():
+        for suite in sorted(path.rglob(UNIT_TEST_SUITE_FILE)):
+            name = suite.parent.resolve().relative_to(tests_dir).as_posix()
+            cases.append(TestCase(path=suite.parent, name=name, unit=True))
+
+    return cases
+
 
 class Test(WestCommand):
     def __init__(self):
@@ -24,6 +183,11 @@ class Test(WestCommand):
             self.name,
             help=self.help,
             description=self.description,
+            formatter_class=argparse.RawDescriptionHelpFormatter,
+            epilog="""\
+Test cases whose keymap and Kconfig only differ in their mock kscan events
+share one build, which then runs each case with its events loaded at runtime.
+Builds are incremental, so running the suite again only rebuilds what changed.""",
         )
 
         parser.add_argument(
@@ -32,11 +196,232 @@ class Test(WestCommand):
             help='The path to the test. Defaults to "all".',
             nargs="?",
         )
+        parser.add_argument(
+            "-j",
+            "--jobs",
+            type=int,
+            default=os.cpu_count() or 1,
+            help="Number of builds and test cases to run in parallel. Defaults to the number of CPUs.",
+        )
+        parser.add_argument(
+            "--no-share",
+            action="store_true",
+            help="Build every test case on its own, like run-test.sh does.",
+        )
+        parser.add_argument(
+            "--auto-accept",
+            action="store_true",
+            default=bool(os.environ.get("ZMK_TESTS_AUTO_ACCEPT")),
+            help="Replace snapshot files with new key events. Also set by ZMK_TESTS_AUTO_ACCEPT.",
+        )
+        parser.add_argument(
+            "-v",
+            "--verbose",
+            action="store_true",
+            default=bool(os.environ.get("ZMK_TESTS_VERBOSE")),
+            help="Show build output. Also set by ZMK_TESTS_VERBOSE.",
+        )
         return parser
 
     def do_run(self, args, unknown_args):
-        # the run-test script assumes the app directory is the current dir.
-        completed_process = subprocess.run(
-            ["./run-test.sh", args.test_path], cwd=self.appdir
+        self.args = args
+        self.build_dir = Path(
+            os.environ.get("ZMK_BUILD_DIR", self.appdir / "build")
+        ).resolve()
+        self.tests_dir = (self.appdir / "tests").resolve()
+        self.extra_modules = os.environ.get("ZMK_EXTRA_MODULES")
+
+        path = self.tests_dir if args.test_path == "all" else Path(args.test_path)
+        if not path.is_absolute() and not path.exists():
+            path = self.appdir / path
+        if not path.exists():
+            log.die(f"{args.test_path} does not exist")
+
+        cases = find_test_cases(path.resolve(), self.tests_dir)
+        if not cases:
+            log.die(f"No test cases found in {args.test_path}")
+
+        groups = self.group_test_cases(cases)
+        log.inf(
+            f"Running {len(cases)} test cases with {len(groups)} builds "
+            f"on {args.jobs} jobs"
+        )
+
+        results = {}
+        # Each build already runs in parallel, so only split the jobs between the builds.
+        build_jobs = max(1, args.jobs // max(1, min(len(groups), args.jobs)))
+        with ThreadPoolExecutor(max_workers=args.jobs) as executor:
+            built = list(executor.map(lambda g: self.build(g, build_jobs), groups))
+
+            runs = []
+            for group, ok in zip(groups, built):
+                for case in group.cases:
+                    if ok:
+                        runs.append((case, executor.submit(self.run_case, group, case)))
+                    else:
+                        results[case.name] = f"FAILED: {case.name} did not build"
+
+            for case, future in runs:
+                results[case.name] = future.result()
+
+        summary = "\n".join(results[name] for name in sorted(results))
+        (self.build_dir / "tests").mkdir(parents=True, exist_ok=True)
+        (self.build_dir / "tests" / "pass-fail.log").write_text(summary + "\n")
+        log.inf(summary)
+
+        failed = sum(1 for r in results.values() if r.startswith("FAILED"))
+        if failed:
+            log.die(f"{failed} of {len(results)} test cases failed")
+
+    def group_test_cases(self, cases: list) -> list:
+        groups = {}
+        for case in cases:
+            if self.args.no_share or case.build_key is None:
+                group = BuildGroup(
+                    build_dir=self.build_dir / "tests" / case.name,
+                    runtime_events=False,
+                )
+                groups[case.name] = group
+            else:
+                group = groups.setdefault(
+                    case.build_key,
+                    BuildGroup(
+                        build_dir=self.build_dir
+                        / "tests"
+                        / "_shared"
+                        / case.build_key[:16]
+                    ),
+                )
+            group.cases.append(case)
+
+        return list(groups.values())
+
+    def build(self, group: BuildGroup, jobs: int) -> bool:
+        if group.cases[0].unit:
+            return self.build_unit_test_suite(group, jobs)
+
+        cmd = [
+            "west",
+            "build",
+            "-s",
+            str(self.appdir),
+            "-d",
+            str(group.build_dir),
+            "-b",
+            BOARD,
+            "-p",
+            "auto",
+            f"-o=-j{jobs}",
+            "--",
+            *BUILD_ARGS,
+            f"-DZMK_CONFIG={group.cases[0].path.resolve()}",
+        ]
+        if group.runtime_events:
+            cmd.append("-DCONFIG_ZMK_KSCAN_MOCK_RUNTIME_EVENTS=y")
+        if self.extra_modules:
+            cmd.append(f"-DZMK_EXTRA_MODULES={Path(self.extra_modules).resolve()}")
+
+        output = None if self.args.verbose else subprocess.DEVNULL
+        return subprocess.run(cmd, stdout=output, stderr=output).returncode == 0
+
+    def build_unit_test_suite(self, group: BuildGroup, jobs: int) -> bool:
+        cmd = [
+            "west",
+            "build",
+            "-s",
+            str(group.cases[0].path.resolve()),
+            "-d",
+            str(group.build_dir),
+            "-b",
+            BOARD,
+            "-p",
+            "auto",
+            f"-o=-j{jobs}",
+            "--",
+            *BUILD_ARGS,
+        ]
+
+        output = None if self.args.verbose else subprocess.DEVNULL
+        return subprocess.run(cmd, stdout=output, stderr=output).returncode == 0
+
+    def run_unit_test_suite(self, group: BuildGroup, case: TestCase) -> str:
+        case_dir = self.build_dir / "tests" / case.name
+        try:
+            result = subprocess.run(
+                [str(group.build_dir / "zephyr" / "zephyr.exe")],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.STDOUT,
+                timeout=CASE_TIMEOUT_SECONDS,
+            )
+            output, passed = result.stdout, result.returncode == 0
+        except subprocess.TimeoutExpired as e:
+            log.inf(f"{case.name} timed out after {CASE_TIMEOUT_SECONDS} seconds")
+            output, passed = e.stdout or b"", False
+
+        (case_dir / "ztest.log").write_bytes(output)
+
+        # The exit code alone would also pass a suite that stopped before running all its tests.
+        if passed and b"PROJECT EXECUTION SUCCESSFUL" in output:
+            return f"PASS: {case.name}"
+
+        log.inf(f"Running {case.name}:\n{output.decode(errors='replace')}")
+        return f"FAILED: {case.name}"
+
+    def run_case(self, group: BuildGroup, case: TestCase) -> str:
+        case_dir = self.build_dir / "tests" / case.name
+        case_dir.mkdir(parents=True, exist_ok=True)
+
+        if case.unit:
+            return self.run_unit_test_suite(group, case)
+
+        cmd = [str(group.build_dir / "zephyr" / "zmk.exe")]
+        if group.runtime_events:
+            events_file = case_dir / "kscan_mock_events"
+            events_file.write_text(
+                "\n".join(f"0x{ev:08x}" for ev in case.events) + "\n"
+            )
+            cmd.append(f"--kscan_mock_events={events_file}")
+
+        try:
+            output = subprocess.run(
+                cmd,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.STDOUT,
+                timeout=CASE_TIMEOUT_SECONDS,
+            ).stdout
+        except subprocess.TimeoutExpired as e:
+            log.inf(f"{case.name} timed out after {CASE_TIMEOUT_SECONDS} seconds")
+            output = e.stdout or b""
+
+        full_log = re.sub(rb"(?m)^.*> ", b"", output)
+        (case_dir / "keycode_events_full.log").write_bytes(full_log)
+
+        filtered = subprocess.run(
+            ["sed", "-n", "-f", str(case.path / "events.patterns")],
+            input=full_log,
+            stdout=subprocess.PIPE,
+        ).stdout
+        log_file = case_dir / "keycode_events.log"
+        log_file.write_bytes(filtered)
+
+        snapshot = case.path / "keycode_events.snapshot"
+        expected = snapshot.read_text()
+        actual = filtered.decode(errors="replace")
+        if snapshot_lines(expected) == snapshot_lines(actual):
+            return f"PASS: {case.name}"
+
+        if (case.path / "pending").exists():
+            return f"PENDING: {case.name}"
+
+        if self.args.auto_accept:
+            shutil.copyfile(log_file, snapshot)
+            return f"PASS: {case.name} (auto-accepted)"
+
+        diff = difflib.unified_diff(
+            expected.splitlines(keepends=True),
+            actual.splitlines(keepends=True),
+            str(snapshot),
+            str(log_file),
         )
-        exit(completed_process.returncode)
+        log.inf(f"Running {case.name}:\n{''.join(diff)}")
+        return f"FAILED: {case.name}"
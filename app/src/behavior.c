@@ -56,6 +56,22 @@ const struct device *z_impl_behavior_get_binding(const char *name) {
     return NULL;
 }
 
+int zmk_behavior_resolve_binding_device(struct zmk_behavior_binding *binding) {
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+    if (binding->behavior_dev == NULL || binding->behavior_dev[0] == '\0') {
+        binding->dev = NULL;
+        return 0;
+    }
+
+    binding->dev = zmk_behavior_get_binding(binding->behavior_dev);
+    if (!binding->dev) {
+        return -ENODEV;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+
+    return 0;
+}
+
 static int invoke_locally(struct zmk_behavior_binding *binding,
                           struct zmk_behavior_binding_event event, bool pressed) {
     if (pressed) {
@@ -71,13 +87,19 @@ int zmk_behavior_invoke_binding(const struct zmk_behavior_binding *src_binding,
     // relative to absolute before being invoked
     struct zmk_behavior_binding binding = *src_binding;
 
-    const struct device *behavior = zmk_behavior_get_binding(binding.behavior_dev);
+    const struct device *behavior = zmk_behavior_get_binding_device(&binding);
 
     if (!behavior) {
         LOG_WRN("No behavior assigned to %d on layer %d", event.position, event.layer);
         return 1;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+    // Carry the resolved device in our copy, so the driver wrappers and any
+    // nested lookups by the behavior itself don't repeat the name search.
+    binding.dev = behavior;
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+
     int err = behavior_keymap_binding_convert_central_state_dependent_params(&binding, event);
     if (err) {
         LOG_ERR("Failed to convert relative to absolute behavior binding (err %d)", err);
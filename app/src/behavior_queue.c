@@ -6,6 +6,7 @@
 
 #include <zmk/behavior_queue.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_timer.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
@@ -25,12 +26,17 @@ struct q_item {
 
 K_MSGQ_DEFINE(zmk_behavior_queue_msgq, sizeof(struct q_item), CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE, 4);
 
-static void behavior_queue_process_next(struct k_work *work);
-static K_WORK_DELAYABLE_DEFINE(queue_work, behavior_queue_process_next);
+static void behavior_queue_process_next(struct zmk_behavior_timer *timer);
+static struct zmk_behavior_timer queue_timer = {.handler = behavior_queue_process_next};
 
-static void behavior_queue_process_next(struct k_work *work) {
+// Behaviors invoked from the queue may add more items to it, which the running loop picks up.
+static bool queue_processing;
+
+static void behavior_queue_process_next(struct zmk_behavior_timer *timer) {
     struct q_item item = {.wait = 0};
 
+    queue_processing = true;
+
     while (k_msgq_get(&zmk_behavior_queue_msgq, &item, K_NO_WAIT) == 0) {
         LOG_DBG("Invoking %s: 0x%02x 0x%02x", item.binding.behavior_dev, item.binding.param1,
                 item.binding.param2);
@@ -51,10 +57,12 @@ static void behavior_queue_process_next(struct k_work *work) {
         LOG_DBG("Processing next queued behavior in %dms", item.wait);
 
         if (item.wait > 0) {
-            k_work_schedule(&queue_work, K_MSEC(item.wait));
+            zmk_behavior_timer_start(&queue_timer, k_uptime_get() + item.wait);
             break;
         }
     }
+
+    queue_processing = false;
 }
 
 int zmk_behavior_queue_add(const struct zmk_behavior_binding_event *event,
@@ -74,8 +82,8 @@ int zmk_behavior_queue_add(const struct zmk_behavior_binding_event *event,
         return ret;
     }
 
-    if (!k_work_delayable_is_pending(&queue_work)) {
-        behavior_queue_process_next(&queue_work.work);
+    if (!queue_processing && !zmk_behavior_timer_is_pending(&queue_timer)) {
+        behavior_queue_process_next(&queue_timer);
     }
 
     return 0;
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zmk/behavior_timer.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#define WHEEL_SLOTS CONFIG_ZMK_BEHAVIOR_TIMER_WHEEL_SLOTS
+
+BUILD_ASSERT((WHEEL_SLOTS & (WHEEL_SLOTS - 1)) == 0,
+             "CONFIG_ZMK_BEHAVIOR_TIMER_WHEEL_SLOTS must be a power of two");
+
+// Timers are hashed into slots by their expiry in milliseconds. A slot can hold timers from later
+// turns of the wheel too, so the expiry of each timer is checked when its slot is visited.
+#define WHEEL_SLOT_INIT(i, _) SYS_DLIST_STATIC_INIT(&wheel[i])
+
+static sys_dlist_t wheel[WHEEL_SLOTS] = {LISTIFY(WHEEL_SLOTS, WHEEL_SLOT_INIT, (, ))};
+
+// One bit per slot that holds at least one timer, so the next slot to visit is found a word at a
+// time instead of walking every slot.
+#define WHEEL_WORD_BITS MIN(WHEEL_SLOTS, 32)
+
+static uint32_t wheel_occupied[DIV_ROUND_UP(WHEEL_SLOTS, 32)];
+
+// All timers that expired at or before this time have been handled.
+static int64_t wheel_time;
+
+// When the wheel work is scheduled to run next, or INT64_MAX if it isn't.
+static int64_t wheel_scheduled_at = INT64_MAX;
+
+static struct k_spinlock lock;
+
+static void wheel_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(wheel_work, wheel_work_handler);
+
+static inline int wheel_slot(int64_t expires_at) { return expires_at & (WHEEL_SLOTS - 1); }
+
+static struct zmk_behavior_timer *timer_from_node(sys_dnode_t *node) {
+    return CONTAINER_OF(node, struct zmk_behavior_timer, node);
+}
+
+// Must be called with the lock held.
+static void wheel_add(struct zmk_behavior_timer *timer) {
+    int slot = wheel_slot(timer->expires_at);
+
+    sys_dlist_append(&wheel[slot], &timer->node);
+    WRITE_BIT(wheel_occupied[slot / 32], slot % 32, 1);
+}
+
+// Must be called with the lock held.
+static void wheel_remove(struct zmk_behavior_timer *timer) {
+    int slot = wheel_slot(timer->expires_at);
+
+    sys_dlist_remove(&timer->node);
+    if (sys_dlist_is_empty(&wheel[slot])) {
+        WRITE_BIT(wheel_occupied[slot / 32], slot % 32, 0);
+    }
+}
+
+// Returns the first time from @p from on whose slot holds a timer, or INT64_MAX if the wheel is
+// empty. Must be called with the lock held.
+static int64_t next_occupied_time(int64_t from) {
+    for (int64_t offset = 0; offset < WHEEL_SLOTS;) {
+        int slot = wheel_slot(from + offset);
+        uint32_t bits = wheel_occupied[slot / 32] >> (slot % 32);
+
+        if (bits) {
+            return from + offset + find_lsb_set(bits) - 1;
+        }
+
+        offset += WHEEL_WORD_BITS - slot % WHEEL_WORD_BITS;
+    }
+
+    return INT64_MAX;
+}
+
+// Returns the earliest expiry of all timers, or INT64_MAX if there are none. Only occupied slots
+// are visited, in time order. A timer due in the current turn of the wheel is earlier than any in
+// a later turn, so the first one found ends the search. Must be called with the lock held.
+static int64_t next_expiry(void) {
+    int64_t next = INT64_MAX;
+
+    for (int64_t time = next_occupied_time(wheel_time + 1); time <= wheel_time + WHEEL_SLOTS;
+         time = next_occupied_time(time + 1)) {
+        struct zmk_behavior_timer *timer;
+        SYS_DLIST_FOR_EACH_CONTAINER(&wheel[wheel_slot(time)], timer, node) {
+            next = MIN(next, timer->expires_at);
+        }
+
+        if (next == time) {
+            break;
+        }
+    }
+
+    return next;
+}
+
+// Must be called with the lock held.
+static void schedule_wheel_work(int64_t expires_at) {
+    if (expires_at >= wheel_scheduled_at) {
+        return;
+    }
+
+    wheel_scheduled_at = expires_at;
+    k_work_reschedule(&wheel_work, K_MSEC(MAX(expires_at - k_uptime_get(), 0)));
+}
+
+// Keeps the expired timers ordered by expiry, then by the order they were started in. They are
+// almost always collected in that order already, so the search starts from the tail.
+static void insert_expired(sys_dlist_t *expired, struct zmk_behavior_timer *timer) {
+    sys_dnode_t *prev = sys_dlist_peek_tail(expired);
+    while (prev != NULL && timer_from_node(prev)->expires_at > timer->expires_at) {
+        prev = sys_dlist_peek_prev(expired, prev);
+    }
+
+    if (prev == NULL) {
+        sys_dlist_prepend(expired, &timer->node);
+        return;
+    }
+
+    sys_dnode_t *next = sys_dlist_peek_next(expired, prev);
+    if (next == NULL) {
+        sys_dlist_append(expired, &timer->node);
+    } else {
+        sys_dlist_insert(next, &timer->node);
+    }
+}
+
+static void wheel_work_handler(struct k_work *work) {
+    sys_dlist_t expired;
+    sys_dlist_init(&expired);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    int64_t now = k_uptime_get();
+    int64_t last = wheel_time + MIN(now - wheel_time, WHEEL_SLOTS);
+    wheel_scheduled_at = INT64_MAX;
+
+    for (int64_t time = next_occupied_time(wheel_time + 1); time <= last;
+         time = next_occupied_time(time + 1)) {
+        struct zmk_behavior_timer *timer, *tmp;
+        SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&wheel[wheel_slot(time)], timer, tmp, node) {
+            if (timer->expires_at <= now) {
+                wheel_remove(timer);
+                insert_expired(&expired, timer);
+            }
+        }
+    }
+
+    wheel_time = now;
+
+    // Handlers may start or stop any timer, including ones that are still waiting in the expired
+    // list, so only take one timer out of it at a time.
+    sys_dnode_t *node;
+    while ((node = sys_dlist_get(&expired)) != NULL) {
+        k_spin_unlock(&lock, key);
+        struct zmk_behavior_timer *timer = timer_from_node(node);
+        timer->handler(timer);
+        key = k_spin_lock(&lock);
+    }
+
+    int64_t next = next_expiry();
+    if (next != INT64_MAX) {
+        schedule_wheel_work(next);
+    }
+
+    k_spin_unlock(&lock, key);
+}
+
+void zmk_behavior_timer_init(struct zmk_behavior_timer *timer,
+                             zmk_behavior_timer_handler_t handler) {
+    sys_dnode_init(&timer->node);
+    timer->expires_at = 0;
+    timer->handler = handler;
+}
+
+void zmk_behavior_timer_start(struct zmk_behavior_timer *timer, int64_t expires_at) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    if (sys_dnode_is_linked(&timer->node)) {
+        wheel_remove(timer);
+    }
+
+    // Timers that are already due are put in the next slot the wheel visits.
+    timer->expires_at = MAX(expires_at, wheel_time + 1);
+    wheel_add(timer);
+    schedule_wheel_work(timer->expires_at);
+
+    k_spin_unlock(&lock, key);
+}
+
+void zmk_behavior_timer_stop(struct zmk_behavior_timer *timer) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    if (sys_dnode_is_linked(&timer->node)) {
+        wheel_remove(timer);
+    }
+
+    k_spin_unlock(&lock, key);
+}
+
+bool zmk_behavior_timer_is_pending(const struct zmk_behavior_timer *timer) {
+    return sys_dnode_is_linked(&timer->node);
+}
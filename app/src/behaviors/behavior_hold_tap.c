@@ -12,6 +12,7 @@
 #include <dt-bindings/zmk/keys.h>
 #include <zephyr/logging/log.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_timer.h>
 #include <zmk/matrix.h>
 #include <zmk/endpoints.h>
 #include <zmk/event_manager.h>
@@ -25,6 +26,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #define ZMK_BHV_HOLD_TAP_MAX_HELD CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_HELD
 #define ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_CAPTURED_EVENTS
+#define ZMK_BHV_HOLD_TAP_TYPING_STREAK_KEYS CONFIG_ZMK_BEHAVIOR_HOLD_TAP_TYPING_STREAK_KEYS
 
 // increase if you have keyboard with more keys.
 #define ZMK_BHV_HOLD_TAP_POSITION_NOT_USED 9999
@@ -50,6 +52,7 @@ enum decision_moment {
     HT_OTHER_KEY_UP,
     HT_TIMER_EVENT,
     HT_QUICK_TAP,
+    HT_TYPING_STREAK,
 };
 
 struct behavior_hold_tap_config {
@@ -58,6 +61,7 @@ struct behavior_hold_tap_config {
     char *tap_behavior_dev;
     int quick_tap_ms;
     int require_prior_idle_ms;
+    int typing_streak_ms;
     enum flavor flavor;
     bool hold_while_undecided;
     bool hold_while_undecided_linger;
@@ -84,8 +88,7 @@ struct active_hold_tap {
     int64_t timestamp;
     enum status status;
     const struct behavior_hold_tap_config *config;
-    struct k_work_delayable work;
-    bool work_is_cancelled;
+    struct zmk_behavior_timer timer;
 
     // initialized to -1, which is to be interpreted as "no other key has been pressed yet"
     int32_t position_of_first_other_key_pressed;
@@ -95,7 +98,7 @@ struct active_hold_tap {
 // other keypress events can be released. While the undecided_hold_tap is
 // not NULL, most events are captured in captured_events.
 // After the hold_tap is decided, it will stay in the active_hold_taps until
-// its key-up has been processed and the delayed work is cleaned up.
+// its key-up has been processed and the timer is stopped.
 struct active_hold_tap *undecided_hold_tap = NULL;
 struct active_hold_tap active_hold_taps[ZMK_BHV_HOLD_TAP_MAX_HELD] = {};
 // We capture most position_state_changed events and some modifiers_state_changed events.
@@ -116,7 +119,22 @@ struct captured_event {
     union captured_event_data data;
 };
 
+// Captured events are kept in a ring buffer in the order they were captured.
 struct captured_event captured_events[ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS] = {};
+static uint32_t captured_events_head;
+static uint32_t captured_events_len;
+
+// The number of events at the head of the ring buffer that are still waiting to be raised by an
+// ongoing release_captured_events().
+static uint32_t captured_events_pending_release;
+
+// Positions with a captured key down event, so that the matching key up can be found without
+// searching the ring buffer.
+static uint32_t captured_keydown_positions[DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)];
+
+// Usage statistics, logged to help size CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_CAPTURED_EVENTS.
+static uint32_t captured_events_high_water;
+static uint32_t captured_events_overflows;
 
 // Keep track of which key was tapped most recently for the standard, if it is a hold-tap
 // a position, will be given, if not it will just be INT32_MIN
@@ -150,28 +168,106 @@ static bool is_quick_tap(struct active_hold_tap *hold_tap) {
     }
 }
 
+static struct captured_event *captured_event_at(uint32_t i) {
+    return &captured_events[(captured_events_head + i) % ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS];
+}
+
+static void set_captured_keydown(uint32_t position, bool captured) {
+    if (position < ZMK_KEYMAP_LEN) {
+        WRITE_BIT(captured_keydown_positions[position / 32], position % 32, captured);
+    }
+}
+
+// A rolling window of the intervals between the most recent key presses, used to tell when the
+// user is in the middle of a fast typing streak.
+struct typing_streak {
+    uint16_t intervals[ZMK_BHV_HOLD_TAP_TYPING_STREAK_KEYS];
+    uint8_t next;
+    uint8_t count;
+    uint32_t sum;
+    int64_t last_press;
+};
+
+static struct typing_streak typing_streak = {.last_press = INT32_MIN};
+
+static void store_key_press(int64_t timestamp) {
+    // Released captured events are raised again with their original timestamp, so this skips
+    // presses that have already been counted.
+    if (timestamp <= typing_streak.last_press) {
+        return;
+    }
+
+    uint16_t interval = MIN(timestamp - typing_streak.last_press, UINT16_MAX);
+    typing_streak.last_press = timestamp;
+
+    if (typing_streak.count == ZMK_BHV_HOLD_TAP_TYPING_STREAK_KEYS) {
+        typing_streak.sum -= typing_streak.intervals[typing_streak.next];
+    } else {
+        typing_streak.count++;
+    }
+
+    typing_streak.intervals[typing_streak.next] = interval;
+    typing_streak.sum += interval;
+    typing_streak.next = (typing_streak.next + 1) % ZMK_BHV_HOLD_TAP_TYPING_STREAK_KEYS;
+}
+
+static bool is_typing_streak(struct active_hold_tap *hold_tap) {
+    if (hold_tap->config->typing_streak_ms < 0 ||
+        typing_streak.count < ZMK_BHV_HOLD_TAP_TYPING_STREAK_KEYS) {
+        return false;
+    }
+
+    // The press of the hold-tap itself is the newest interval in the window, so a pause right
+    // before it ends the streak.
+    return typing_streak.sum <
+           (uint32_t)hold_tap->config->typing_streak_ms * ZMK_BHV_HOLD_TAP_TYPING_STREAK_KEYS;
+}
+
 static int capture_event(struct captured_event *data) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS; i++) {
-        if (captured_events[i].tag == ET_NONE) {
-            captured_events[i] = *data;
-            return 0;
-        }
+    if (captured_events_len == ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS) {
+        return -ENOMEM;
+    }
+
+    *captured_event_at(captured_events_len++) = *data;
+
+    // A key up means the position has no pressed key left to match, even if the key down is still
+    // in the buffer.
+    if (data->tag == ET_POS_CHANGED) {
+        set_captured_keydown(data->data.position.data.position, data->data.position.data.state);
+    }
+
+    if (captured_events_len > captured_events_high_water) {
+        captured_events_high_water = captured_events_len;
+        LOG_DBG("Captured %d of %d events", captured_events_high_water,
+                ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS);
+    }
+
+    return 0;
+}
+
+static struct captured_event pop_captured_event(void) {
+    struct captured_event ev = *captured_event_at(0);
+
+    captured_events_head = (captured_events_head + 1) % ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS;
+    captured_events_len--;
+
+    if (ev.tag == ET_POS_CHANGED && ev.data.position.data.state) {
+        set_captured_keydown(ev.data.position.data.position, false);
     }
-    return -ENOMEM;
+
+    return ev;
 }
 
 static bool have_captured_keydown_event(uint32_t position) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS; i++) {
-        struct captured_event *ev = &captured_events[i];
-        if (ev->tag == ET_NONE) {
-            return false;
-        }
-
-        if (ev->tag != ET_POS_CHANGED) {
-            continue;
-        }
+    if (position < ZMK_KEYMAP_LEN) {
+        return captured_keydown_positions[position / 32] & BIT(position % 32);
+    }
 
-        if (ev->data.position.data.position == position && ev->data.position.data.state) {
+    // Positions outside the keymap aren't tracked by the bitmap, so search the buffer instead.
+    for (uint32_t i = 0; i < captured_events_len; i++) {
+        struct captured_event *ev = captured_event_at(i);
+        if (ev->tag == ET_POS_CHANGED && ev->data.position.data.position == position &&
+            ev->data.position.data.state) {
             return true;
         }
     }
@@ -185,56 +281,50 @@ static void release_captured_events() {
         return;
     }
 
-    // We use a trick to prevent copying the captured_events array.
-    //
-    // Events for different mod-tap instances are separated by a NULL pointer.
-    //
-    // The first event popped will never be caught by the next active hold-tap
-    // because to start capturing a mod-tap-key-down event must first completely
-    // go through the events queue.
+    // Releasing an event can make another hold-tap undecided, which then captures the following
+    // events we release by appending them to the buffer. If it is decided before we reach the end
+    // of our pending events, its captured events happened before the ones we have not released
+    // yet, so move our remaining events after them and release everything in order from here.
     //
     // Example of this release process;
-    // [mt2_down, k1_down, k1_up, mt2_up, null, ...]
+    // [mt2_down, k1_down, k1_up, mt2_up, k2_down]
     //  ^
     // mt2_down position event isn't captured because no hold-tap is active.
     // mt2_down behavior event is handled, now we have an undecided hold-tap
-    // [null, k1_down, k1_up, mt2_up, null, ...]
-    //        ^
-    // k1_down  is captured by the mt2 mod-tap
-    // !note that searches for find_captured_keydown_event by the mt2 behavior will stop at the
-    // first null encountered [mt1_down, null, k1_up, mt2_up, null, ...]
-    //                  ^
-    // k1_up event is captured by the new hold-tap:
-    // [k1_down, k1_up, null, mt2_up, null, ...]
-    //                        ^
-    // mt2_up event is not captured but causes release of mt2 behavior
-    // [k1_down, k1_up, null, null, null, ...]
-    // now mt2 will start releasing it's own captured positions.
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS; i++) {
-        struct captured_event *captured_event = &captured_events[i];
-        enum captured_event_tag tag = captured_event->tag;
-
-        if (tag == ET_NONE) {
-            return;
-        }
+    // [k1_down, k1_up, mt2_up, k2_down]
+    //  ^
+    // k1_down and k1_up are captured by the mt2 mod-tap
+    // [mt2_up, k2_down, k1_down, k1_up]
+    //  ^
+    // mt2_up event is not captured but causes release of mt2 behavior, which moves k2_down
+    // to the end and continues releasing the whole buffer.
+    // [k1_down, k1_up, k2_down]
+    for (uint32_t i = 0; i < captured_events_pending_release; i++) {
+        *captured_event_at(captured_events_len) = *captured_event_at(0);
+        captured_events_head = (captured_events_head + 1) % ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS;
+    }
+    captured_events_pending_release = captured_events_len;
+
+    while (captured_events_pending_release > 0) {
+        struct captured_event captured_event = pop_captured_event();
+        captured_events_pending_release--;
 
-        captured_events[i].tag = ET_NONE;
         if (undecided_hold_tap != NULL) {
             k_msleep(10);
         }
 
-        switch (tag) {
+        switch (captured_event.tag) {
         case ET_CODE_CHANGED:
             LOG_DBG("Releasing mods changed event 0x%02X %s",
-                    captured_event->data.keycode.data.keycode,
-                    (captured_event->data.keycode.data.state ? "pressed" : "released"));
-            ZMK_EVENT_RAISE_AT(captured_event->data.keycode, behavior_hold_tap);
+                    captured_event.data.keycode.data.keycode,
+                    (captured_event.data.keycode.data.state ? "pressed" : "released"));
+            ZMK_EVENT_RAISE_AT(captured_event.data.keycode, behavior_hold_tap);
             break;
         case ET_POS_CHANGED:
             LOG_DBG("Releasing key position event for position %d %s",
-                    captured_event->data.position.data.position,
-                    (captured_event->data.position.data.state ? "pressed" : "released"));
-            ZMK_EVENT_RAISE_AT(captured_event->data.position, behavior_hold_tap);
+                    captured_event.data.position.data.position,
+                    (captured_event.data.position.data.state ? "pressed" : "released"));
+            ZMK_EVENT_RAISE_AT(captured_event.data.position, behavior_hold_tap);
             break;
         default:
             LOG_ERR("Unhandled captured event type");
@@ -277,7 +367,6 @@ static struct active_hold_tap *store_hold_tap(struct zmk_behavior_binding_event
 static void clear_hold_tap(struct active_hold_tap *hold_tap) {
     hold_tap->position = ZMK_BHV_HOLD_TAP_POSITION_NOT_USED;
     hold_tap->status = STATUS_UNDECIDED;
-    hold_tap->work_is_cancelled = false;
 }
 
 static void decide_balanced(struct active_hold_tap *hold_tap, enum decision_moment event) {
@@ -292,6 +381,7 @@ static void decide_balanced(struct active_hold_tap *hold_tap, enum decision_mome
         hold_tap->status = STATUS_HOLD_TIMER;
         return;
     case HT_QUICK_TAP:
+    case HT_TYPING_STREAK:
         hold_tap->status = STATUS_TAP;
         return;
     default:
@@ -308,6 +398,7 @@ static void decide_tap_preferred(struct active_hold_tap *hold_tap, enum decision
         hold_tap->status = STATUS_HOLD_TIMER;
         return;
     case HT_QUICK_TAP:
+    case HT_TYPING_STREAK:
         hold_tap->status = STATUS_TAP;
         return;
     default:
@@ -328,6 +419,7 @@ static void decide_tap_unless_interrupted(struct active_hold_tap *hold_tap,
         hold_tap->status = STATUS_TAP;
         return;
     case HT_QUICK_TAP:
+    case HT_TYPING_STREAK:
         hold_tap->status = STATUS_TAP;
         return;
     default:
@@ -347,6 +439,7 @@ static void decide_hold_preferred(struct active_hold_tap *hold_tap, enum decisio
         hold_tap->status = STATUS_HOLD_TIMER;
         return;
     case HT_QUICK_TAP:
+    case HT_TYPING_STREAK:
         hold_tap->status = STATUS_TAP;
         return;
     default:
@@ -394,6 +487,8 @@ static inline const char *decision_moment_str(enum decision_moment decision_mome
         return "other-key-up";
     case HT_QUICK_TAP:
         return "quick-tap";
+    case HT_TYPING_STREAK:
+        return "typing-streak";
     case HT_TIMER_EVENT:
         return "timer";
     default:
@@ -605,7 +700,7 @@ static void update_hold_status_for_retro_tap(uint32_t ignore_position) {
 
 static int on_hold_tap_binding_pressed(struct zmk_behavior_binding *binding,
                                        struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_get_binding_device(binding);
     const struct behavior_hold_tap_config *cfg = dev->config;
 
     if (undecided_hold_tap != NULL) {
@@ -628,14 +723,14 @@ static int on_hold_tap_binding_pressed(struct zmk_behavior_binding *binding,
 
     if (is_quick_tap(hold_tap)) {
         decide_hold_tap(hold_tap, HT_QUICK_TAP);
+    } else if (is_typing_streak(hold_tap)) {
+        decide_hold_tap(hold_tap, HT_TYPING_STREAK);
     }
 
     decide_hold_tap(hold_tap, HT_KEY_DOWN);
 
-    // if this behavior was queued we have to adjust the timer to only
-    // wait for the remaining time.
-    int32_t tapping_term_ms_left = (hold_tap->timestamp + cfg->tapping_term_ms) - k_uptime_get();
-    k_work_schedule(&hold_tap->work, K_MSEC(tapping_term_ms_left));
+    // if this behavior was queued, the timer only waits for the remaining time.
+    zmk_behavior_timer_start(&hold_tap->timer, hold_tap->timestamp + cfg->tapping_term_ms);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -650,7 +745,7 @@ static int on_hold_tap_binding_released(struct zmk_behavior_binding *binding,
 
     // If these events were queued, the timer event may be queued too late or not at all.
     // We insert a timer event before the TH_KEY_UP event to verify.
-    int work_cancel_result = k_work_cancel_delayable(&hold_tap->work);
+    zmk_behavior_timer_stop(&hold_tap->timer);
     if (event.timestamp > (hold_tap->timestamp + hold_tap->config->tapping_term_ms)) {
         decide_hold_tap(hold_tap, HT_TIMER_EVENT);
     }
@@ -663,15 +758,8 @@ static int on_hold_tap_binding_released(struct zmk_behavior_binding *binding,
         release_hold_binding(hold_tap);
     }
 
-    if (work_cancel_result == -EINPROGRESS) {
-        // let the timer handler clean up
-        // if we'd clear now, the timer may call back for an uninitialized active_hold_tap.
-        LOG_DBG("%d hold-tap timer work in event queue", event.position);
-        hold_tap->work_is_cancelled = true;
-    } else {
-        LOG_DBG("%d cleaning up hold-tap", event.position);
-        clear_hold_tap(hold_tap);
-    }
+    LOG_DBG("%d cleaning up hold-tap", event.position);
+    clear_hold_tap(hold_tap);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -724,9 +812,23 @@ static const struct behavior_driver_api behavior_hold_tap_driver_api = {
 #endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
 };
 
+// Rather than dropping events when the capture buffer is full, decide the undecided hold-tap as if
+// its tapping term had expired, which releases its captured events and frees up the buffer.
+static void resolve_capture_overflow(void) {
+    captured_events_overflows++;
+    LOG_WRN("%d capture buffer full, deciding early (%d overflows, consider increasing "
+            "CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_CAPTURED_EVENTS)",
+            undecided_hold_tap->position, captured_events_overflows);
+    decide_hold_tap(undecided_hold_tap, HT_TIMER_EVENT);
+}
+
 static int position_state_changed_listener(const zmk_event_t *eh) {
     struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
 
+    if (ev->state) {
+        store_key_press(ev->timestamp);
+    }
+
     update_hold_status_for_retro_tap(ev->position);
 
     if (undecided_hold_tap == NULL) {
@@ -774,6 +876,11 @@ static int position_state_changed_listener(const zmk_event_t *eh) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
+    if (captured_events_len == ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS) {
+        resolve_capture_overflow();
+        return position_state_changed_listener(eh);
+    }
+
     LOG_DBG("%d capturing %d %s event", undecided_hold_tap->position, ev->position,
             ev->state ? "down" : "up");
     struct captured_event capture = {
@@ -809,6 +916,11 @@ static int keycode_state_changed_listener(const zmk_event_t *eh) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
+    if (captured_events_len == ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS) {
+        resolve_capture_overflow();
+        return keycode_state_changed_listener(eh);
+    }
+
     // only key-up events will bubble through position_state_changed_listener
     // if a undecided_hold_tap is active.
     LOG_DBG("%d capturing 0x%02X %s event", undecided_hold_tap->position, ev->keycode,
@@ -833,15 +945,10 @@ ZMK_SUBSCRIPTION(behavior_hold_tap, zmk_position_state_changed);
 // this should be modifiers_state_changed, but unfrotunately that's not implemented yet.
 ZMK_SUBSCRIPTION(behavior_hold_tap, zmk_keycode_state_changed);
 
-void behavior_hold_tap_timer_work_handler(struct k_work *item) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(item);
-    struct active_hold_tap *hold_tap = CONTAINER_OF(d_work, struct active_hold_tap, work);
+void behavior_hold_tap_timer_handler(struct zmk_behavior_timer *timer) {
+    struct active_hold_tap *hold_tap = CONTAINER_OF(timer, struct active_hold_tap, timer);
 
-    if (hold_tap->work_is_cancelled) {
-        clear_hold_tap(hold_tap);
-    } else {
-        decide_hold_tap(hold_tap, HT_TIMER_EVENT);
-    }
+    decide_hold_tap(hold_tap, HT_TIMER_EVENT);
 }
 
 static int behavior_hold_tap_init(const struct device *dev) {
@@ -849,7 +956,7 @@ static int behavior_hold_tap_init(const struct device *dev) {
 
     if (init_first_run) {
         for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_HELD; i++) {
-            k_work_init_delayable(&active_hold_taps[i].work, behavior_hold_tap_timer_work_handler);
+            zmk_behavior_timer_init(&active_hold_taps[i].timer, behavior_hold_tap_timer_handler);
             active_hold_taps[i].position = ZMK_BHV_HOLD_TAP_POSITION_NOT_USED;
         }
     }
@@ -866,6 +973,7 @@ static int behavior_hold_tap_init(const struct device *dev) {
         .require_prior_idle_ms = DT_INST_PROP(n, global_quick_tap)                                 \
                                      ? DT_INST_PROP(n, quick_tap_ms)                               \
                                      : DT_INST_PROP(n, require_prior_idle_ms),                     \
+        .typing_streak_ms = DT_INST_PROP(n, typing_streak_ms),                                     \
         .flavor = DT_ENUM_IDX(DT_DRV_INST(n), flavor),                                             \
         .hold_while_undecided = DT_INST_PROP(n, hold_while_undecided),                             \
         .hold_while_undecided_linger = DT_INST_PROP(n, hold_while_undecided_linger),               \
@@ -259,7 +259,7 @@ static int behavior_input_two_axis_init(const struct device *dev) {
 static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                      struct zmk_behavior_binding_event event) {
 
-    const struct device *behavior_dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *behavior_dev = zmk_behavior_get_binding_device(binding);
 
     LOG_DBG("position %d keycode 0x%02X", event.position, binding->param1);
 
@@ -272,7 +272,7 @@ static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
 
 static int on_keymap_binding_released(struct zmk_behavior_binding *binding,
                                       struct zmk_behavior_binding_event event) {
-    const struct device *behavior_dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *behavior_dev = zmk_behavior_get_binding_device(binding);
 
     LOG_DBG("position %d keycode 0x%02X", event.position, binding->param1);
 
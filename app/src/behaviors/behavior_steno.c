@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_behavior_steno
+
+#include <zephyr/device.h>
+#include <drivers/behavior.h>
+#include <zephyr/logging/log.h>
+
+#include <dt-bindings/zmk/steno.h>
+
+#include <zmk/behavior.h>
+#include <zmk/events/steno_stroke.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+// A stroke is every steno key pressed from the first key down until all steno keys are up again,
+// so only the accumulated keys and a count of the held bindings need to be tracked, whatever the
+// number of keys in the stroke.
+static uint64_t stroke_keys;
+static uint32_t held_count;
+
+static int behavior_steno_init(const struct device *dev) { return 0; }
+
+static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
+                                     struct zmk_behavior_binding_event event) {
+    if (binding->param1 >= STENO_KEYS_LEN) {
+        LOG_ERR("Invalid steno key %d", binding->param1);
+        return -EINVAL;
+    }
+
+    LOG_DBG("position %d steno key %d", event.position, binding->param1);
+
+    stroke_keys |= BIT64(binding->param1);
+    held_count++;
+
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int on_keymap_binding_released(struct zmk_behavior_binding *binding,
+                                      struct zmk_behavior_binding_event event) {
+    if (binding->param1 >= STENO_KEYS_LEN || held_count == 0) {
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+
+    if (--held_count > 0) {
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+
+    struct zmk_steno_stroke stroke = {.keys = stroke_keys, .timestamp = event.timestamp};
+    stroke_keys = 0;
+
+    raise_zmk_steno_stroke(stroke);
+
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+
+static const struct behavior_parameter_value_metadata param_values[] = {
+    {
+        .display_name = "Steno Key",
+        .type = BEHAVIOR_PARAMETER_VALUE_TYPE_RANGE,
+        .range = {.min = 0, .max = STENO_KEYS_LEN - 1},
+    },
+};
+
+static const struct behavior_parameter_metadata_set param_metadata_set[] = {{
+    .param1_values = param_values,
+    .param1_values_len = ARRAY_SIZE(param_values),
+}};
+
+static const struct behavior_parameter_metadata metadata = {
+    .sets_len = ARRAY_SIZE(param_metadata_set),
+    .sets = param_metadata_set,
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+
+static const struct behavior_driver_api behavior_steno_driver_api = {
+    .binding_pressed = on_keymap_binding_pressed,
+    .binding_released = on_keymap_binding_released,
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+    .parameter_metadata = &metadata,
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+};
+
+#define STENO_INST(n)                                                                              \
+    BEHAVIOR_DT_INST_DEFINE(n, behavior_steno_init, NULL, NULL, NULL, POST_KERNEL,                 \
+                            CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &behavior_steno_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(STENO_INST)
+
+#endif /* DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT) */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include <stdlib.h>
+#include <time.h>
+
+#if IS_ENABLED(CONFIG_INPUT)
+#include <zephyr/input/input.h>
+#endif
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/keycode_state_changed.h>
+
+// Benchmarks run on native_posix, where simulated time doesn't advance while code executes, so all
+// timings here use the host process CPU clock. Results are printed with printk from an atexit
+// handler, since the mock drivers end the run by calling exit() and deferred logs would be lost.
+
+static uint64_t start_ns;
+static uint32_t position_events;
+static uint32_t keycode_events;
+static uint32_t input_events;
+
+static uint64_t cpu_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void mark_started(void) {
+    if (start_ns == 0) {
+        start_ns = cpu_time_ns();
+    }
+}
+
+static int benchmark_listener(const zmk_event_t *eh) {
+    if (as_zmk_position_state_changed(eh)) {
+        mark_started();
+        position_events++;
+    } else if (as_zmk_keycode_state_changed(eh)) {
+        keycode_events++;
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(benchmark, benchmark_listener);
+ZMK_SUBSCRIPTION(benchmark, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(benchmark, zmk_keycode_state_changed);
+
+#if IS_ENABLED(CONFIG_INPUT)
+
+static void benchmark_input_cb(struct input_event *evt) {
+    mark_started();
+    input_events++;
+}
+
+INPUT_CALLBACK_DEFINE(NULL, benchmark_input_cb);
+
+#endif // IS_ENABLED(CONFIG_INPUT)
+
+static void print_thread_stack(const struct k_thread *thread, void *user_data) {
+    size_t unused;
+    const char *name = k_thread_name_get((k_tid_t)thread);
+
+    if (k_thread_stack_space_get(thread, &unused) < 0) {
+        return;
+    }
+
+    printk("BENCHMARK: stack %s %zu/%zu bytes peak\n", name ? name : "unnamed",
+           thread->stack_info.size - unused, thread->stack_info.size);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+
+static void print_listener_stats(const struct zmk_event_type *type,
+                                 const struct zmk_event_type_stats *type_stats,
+                                 const struct zmk_listener *listener,
+                                 const struct zmk_listener_stats *listener_stats,
+                                 void *user_data) {
+    if (listener_stats->calls == 0) {
+        return;
+    }
+
+    uint64_t avg_cycles = listener_stats->total_cycles / listener_stats->calls;
+
+    printk("BENCHMARK: listener %s/%s %d calls, avg %dus, max %dus\n", type->name, listener->name,
+           listener_stats->calls, zmk_event_manager_stats_cycles_to_us(avg_cycles),
+           zmk_event_manager_stats_cycles_to_us(listener_stats->max_cycles));
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+
+static void benchmark_report(void) {
+    uint64_t elapsed_ns = start_ns ? cpu_time_ns() - start_ns : 0;
+    uint32_t events = position_events + input_events;
+
+    printk("BENCHMARK: %d position events, %d keycode events, %d input events\n", position_events,
+           keycode_events, input_events);
+    printk("BENCHMARK: cpu %dus\n", (uint32_t)(elapsed_ns / NSEC_PER_USEC));
+
+    if (events > 0 && elapsed_ns > 0) {
+        printk("BENCHMARK: %d ns per event, %d events/s\n", (uint32_t)(elapsed_ns / events),
+               (uint32_t)((uint64_t)events * NSEC_PER_SEC / elapsed_ns));
+    }
+
+    k_thread_foreach(print_thread_stack, NULL);
+
+#if IS_ENABLED(CONFIG_SYS_HEAP_RUNTIME_STATS) && CONFIG_HEAP_MEM_POOL_SIZE > 0
+    extern struct k_heap _system_heap;
+    struct sys_memory_stats heap_stats;
+
+    if (sys_heap_runtime_stats_get(&_system_heap.heap, &heap_stats) == 0) {
+        printk("BENCHMARK: heap %zu/%d bytes peak\n", heap_stats.max_allocated_bytes,
+               CONFIG_HEAP_MEM_POOL_SIZE);
+    }
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    zmk_event_manager_stats_foreach(print_listener_stats, NULL);
+#endif
+}
+
+static int benchmark_init(void) { return atexit(benchmark_report); }
+
+SYS_INIT(benchmark_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
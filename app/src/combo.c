@@ -14,6 +14,7 @@
 #include <drivers/behavior.h>
 
 #include <zmk/behavior.h>
+#include <zmk/behavior_timer.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
@@ -43,7 +44,7 @@ struct combo_cfg {
 };
 
 struct active_combo {
-    struct combo_cfg *combo;
+    const struct combo_cfg *combo;
     // key_positions_pressed is filled with key_positions when the combo is pressed.
     // The keys are removed from this array when they are released.
     // Once this array is empty, the behavior is released.
@@ -52,30 +53,120 @@ struct active_combo {
         key_positions_pressed[CONFIG_ZMK_COMBO_MAX_KEYS_PER_COMBO];
 };
 
-struct combo_candidate {
-    struct combo_cfg *combo;
-    // the time after which this behavior should be removed from candidates.
-    // by keeping track of when the candidate should be cleared there is no
-    // possibility of accidental releases.
-    int64_t timeout_at;
-};
+#define COMBO_ONE(n) +1
+#define COMBOS_LEN (0 DT_INST_FOREACH_CHILD(0, COMBO_ONE))
+
+#if COMBOS_LEN <= 32
+#define COMBO_SET_WORDS 1
+#elif COMBOS_LEN <= 64
+#define COMBO_SET_WORDS 2
+#elif COMBOS_LEN <= 96
+#define COMBO_SET_WORDS 3
+#elif COMBOS_LEN <= 128
+#define COMBO_SET_WORDS 4
+#elif COMBOS_LEN <= 160
+#define COMBO_SET_WORDS 5
+#elif COMBOS_LEN <= 192
+#define COMBO_SET_WORDS 6
+#elif COMBOS_LEN <= 224
+#define COMBO_SET_WORDS 7
+#elif COMBOS_LEN <= 256
+#define COMBO_SET_WORDS 8
+#elif COMBOS_LEN <= 288
+#define COMBO_SET_WORDS 9
+#elif COMBOS_LEN <= 320
+#define COMBO_SET_WORDS 10
+#elif COMBOS_LEN <= 352
+#define COMBO_SET_WORDS 11
+#elif COMBOS_LEN <= 384
+#define COMBO_SET_WORDS 12
+#elif COMBOS_LEN <= 416
+#define COMBO_SET_WORDS 13
+#elif COMBOS_LEN <= 448
+#define COMBO_SET_WORDS 14
+#elif COMBOS_LEN <= 480
+#define COMBO_SET_WORDS 15
+#elif COMBOS_LEN <= 512
+#define COMBO_SET_WORDS 16
+#else
+#error "More than 512 combos are not supported"
+#endif
+
+// Combos are matched as sets of indexes into `combos`, one bit per combo. Filtering candidates on
+// a key press is then an AND with the combos on that position, whatever the number of combos.
+typedef uint32_t combo_set_t[COMBO_SET_WORDS];
+
+#define FOR_EACH_COMBO_IN_SET(set, idx)                                                            \
+    for (int _w = 0, idx; _w < COMBO_SET_WORDS; _w++)                                              \
+        for (uint32_t _bits = (set)[_w];                                                           \
+             _bits && (idx = _w * 32 + __builtin_ctz(_bits), true); _bits &= _bits - 1)
+
+#define COMBO_INST(n)                                                                              \
+    static const struct combo_cfg combo_config_##n = {                                             \
+        .timeout_ms = DT_PROP(n, timeout_ms),                                                      \
+        .require_prior_idle_ms = DT_PROP(n, require_prior_idle_ms),                                \
+        .key_positions = DT_PROP(n, key_positions),                                                \
+        .key_position_len = DT_PROP_LEN(n, key_positions),                                         \
+        .behavior = ZMK_KEYMAP_EXTRACT_BINDING(0, n),                                              \
+        .virtual_key_position = ZMK_VIRTUAL_KEY_POSITION_COMBO(DT_NODE_CHILD_IDX(n)),              \
+        .slow_release = DT_PROP(n, slow_release),                                                  \
+        .layers = DT_PROP(n, layers),                                                              \
+        .layers_len = DT_PROP_LEN(n, layers),                                                      \
+    };
+
+DT_INST_FOREACH_CHILD(0, COMBO_INST)
+
+// A combo's rank is the number of combos sorted before it, shortest-first, then by
+// virtual-key-position, which follows the devicetree order.
+#define COMBO_PRECEDES(other, n)                                                                   \
+    +(DT_PROP_LEN(other, key_positions) < DT_PROP_LEN(n, key_positions) ||                         \
+      (DT_PROP_LEN(other, key_positions) == DT_PROP_LEN(n, key_positions) &&                       \
+       DT_NODE_CHILD_IDX(other) < DT_NODE_CHILD_IDX(n)))
+
+#define COMBO_RANK(n) (0 DT_INST_FOREACH_CHILD_VARGS(0, COMBO_PRECEDES, n))
+
+// Ranks are enum constants, so the table below is indexed without repeating the expansion above.
+#define COMBO_RANK_CONST(n) combo_rank_##n = COMBO_RANK(n),
+
+enum { DT_INST_FOREACH_CHILD(0, COMBO_RANK_CONST) COMBO_RANKS_END };
+
+#define COMBO_BY_RANK(n) [combo_rank_##n] = &combo_config_##n,
 
 uint32_t pressed_keys_count = 0;
 // set of keys pressed
 struct zmk_position_state_changed_event pressed_keys[CONFIG_ZMK_COMBO_MAX_KEYS_PER_COMBO] = {};
+// all combos, sorted shortest-first, then by virtual-key-position. a combo's index in this array
+// is its bit in a combo_set_t, so the lowest candidate is the preferred one.
+static const struct combo_cfg *const combos[COMBOS_LEN] = {
+    DT_INST_FOREACH_CHILD(0, COMBO_BY_RANK)};
 // the set of candidate combos based on the currently pressed_keys
-struct combo_candidate candidates[CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY];
+combo_set_t candidates;
+// when the first of the pressed_keys was pressed, which candidate timeouts are relative to.
+// by keeping track of when the candidates should be cleared there is no
+// possibility of accidental releases.
+int64_t candidates_pressed_at;
 // the last candidate that was completely pressed
-struct combo_cfg *fully_pressed_combo = NULL;
+const struct combo_cfg *fully_pressed_combo = NULL;
+
+// The lookups below are filled once at boot from `combos`, which visits every key position and
+// layer of every combo a single time. Each entry is the set of combos on that position or layer.
+
 // a lookup dict that maps a key position to all combos on that position
-struct combo_cfg *combo_lookup[ZMK_KEYMAP_LEN][CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY] = {NULL};
+static combo_set_t combo_lookup[ZMK_KEYMAP_LEN];
+
+// a lookup dict that maps a layer to the combos limited to that layer
+static combo_set_t combo_layer_lookup[ZMK_KEYMAP_LAYERS_LEN];
+
+// the set of combos active on every layer
+static combo_set_t combo_global_lookup;
+
 // combos that have been activated and still have (some) keys pressed
 // this array is always contiguous from 0.
 struct active_combo active_combos[CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS] = {NULL};
 int active_combo_count = 0;
 
-struct k_work_delayable timeout_task;
-int64_t timeout_task_timeout_at;
+struct zmk_behavior_timer timeout_timer;
+int64_t timeout_timer_expires_at;
 
 // this keeps track of the last non-combo, non-mod key tap
 int64_t last_tapped_timestamp = INT32_MIN;
@@ -88,126 +179,97 @@ static void store_last_tapped(int64_t timestamp) {
     }
 }
 
-// Store the combo key pointer in the combos array, one pointer for each key position
-// The combos are sorted shortest-first, then by virtual-key-position.
-static int initialize_combo(struct combo_cfg *new_combo) {
-    for (int i = 0; i < new_combo->key_position_len; i++) {
-        int32_t position = new_combo->key_positions[i];
-        if (position >= ZMK_KEYMAP_LEN) {
-            LOG_ERR("Unable to initialize combo, key position %d does not exist", position);
-            return -EINVAL;
-        }
+static void combo_set_add(combo_set_t set, int idx) { set[idx / 32] |= BIT(idx % 32); }
 
-        struct combo_cfg *insert_combo = new_combo;
-        bool set = false;
-        for (int j = 0; j < CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY; j++) {
-            struct combo_cfg *combo_at_j = combo_lookup[position][j];
-            if (combo_at_j == NULL) {
-                combo_lookup[position][j] = insert_combo;
-                set = true;
-                break;
-            }
-            if (combo_at_j->key_position_len < insert_combo->key_position_len ||
-                (combo_at_j->key_position_len == insert_combo->key_position_len &&
-                 combo_at_j->virtual_key_position < insert_combo->virtual_key_position)) {
+static void initialize_combo_lookups(void) {
+    for (int idx = 0; idx < COMBOS_LEN; idx++) {
+        const struct combo_cfg *combo = combos[idx];
+
+        for (int i = 0; i < combo->key_position_len; i++) {
+            int32_t position = combo->key_positions[i];
+            if (position >= ZMK_KEYMAP_LEN) {
+                LOG_ERR("Unable to initialize combo, key position %d does not exist", position);
                 continue;
             }
-            // put insert_combo in this spot, move all other combos up.
-            combo_lookup[position][j] = insert_combo;
-            insert_combo = combo_at_j;
+            combo_set_add(combo_lookup[position], idx);
+        }
+
+        // -1 in the first layer position is global layer scope
+        if (combo->layers[0] == -1) {
+            combo_set_add(combo_global_lookup, idx);
+            continue;
         }
-        if (!set) {
-            LOG_ERR("Too many combos for key position %d, CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY %d.",
-                    position, CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY);
-            return -ENOMEM;
+        for (int i = 0; i < combo->layers_len; i++) {
+            if (combo->layers[i] >= 0 && combo->layers[i] < ZMK_KEYMAP_LAYERS_LEN) {
+                combo_set_add(combo_layer_lookup[combo->layers[i]], idx);
+            }
         }
     }
-    return 0;
 }
 
-static bool combo_active_on_layer(struct combo_cfg *combo, uint8_t layer) {
-    if (combo->layers[0] == -1) {
-        // -1 in the first layer position is global layer scope
-        return true;
-    }
-    for (int j = 0; j < combo->layers_len; j++) {
-        if (combo->layers[j] == layer) {
-            return true;
+static bool is_quick_tap(const struct combo_cfg *combo, int64_t timestamp) {
+    return (last_tapped_timestamp + combo->require_prior_idle_ms) > timestamp;
+}
+
+static inline int first_candidate(void) {
+    for (int w = 0; w < COMBO_SET_WORDS; w++) {
+        if (candidates[w]) {
+            return w * 32 + __builtin_ctz(candidates[w]);
         }
     }
-    return false;
+    return -1;
 }
 
-static bool is_quick_tap(struct combo_cfg *combo, int64_t timestamp) {
-    return (last_tapped_timestamp + combo->require_prior_idle_ms) > timestamp;
+static inline int count_candidates(void) {
+    int count = 0;
+    for (int w = 0; w < COMBO_SET_WORDS; w++) {
+        count += __builtin_popcount(candidates[w]);
+    }
+    return count;
+}
+
+static inline int64_t candidate_timeout(int idx) {
+    return candidates_pressed_at + combos[idx]->timeout_ms;
 }
 
 static int setup_candidates_for_first_keypress(int32_t position, int64_t timestamp) {
-    int number_of_combo_candidates = 0;
     uint8_t highest_active_layer = zmk_keymap_highest_layer_active();
-    for (int i = 0; i < CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY; i++) {
-        struct combo_cfg *combo = combo_lookup[position][i];
-        if (combo == NULL) {
-            return number_of_combo_candidates;
-        }
-        if (combo_active_on_layer(combo, highest_active_layer) && !is_quick_tap(combo, timestamp)) {
-            candidates[number_of_combo_candidates].combo = combo;
-            candidates[number_of_combo_candidates].timeout_at = timestamp + combo->timeout_ms;
-            number_of_combo_candidates++;
+    for (int w = 0; w < COMBO_SET_WORDS; w++) {
+        candidates[w] = combo_lookup[position][w] & (combo_layer_lookup[highest_active_layer][w] |
+                                                     combo_global_lookup[w]);
+    }
+
+    FOR_EACH_COMBO_IN_SET(candidates, idx) {
+        if (is_quick_tap(combos[idx], timestamp)) {
+            WRITE_BIT(candidates[idx / 32], idx % 32, 0);
         }
-        // LOG_DBG("combo timeout %d %d %d", position, i, candidates[i].timeout_at);
     }
-    return number_of_combo_candidates;
+
+    candidates_pressed_at = timestamp;
+
+    return count_candidates();
 }
 
 static int filter_candidates(int32_t position) {
-    // this code iterates over candidates and the lookup together to filter in O(n)
-    // assuming they are both sorted on key_position_len, virtual_key_position
-    int matches = 0, lookup_idx = 0, candidate_idx = 0;
-    while (lookup_idx < CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY &&
-           candidate_idx < CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY) {
-        struct combo_cfg *candidate = candidates[candidate_idx].combo;
-        struct combo_cfg *lookup = combo_lookup[position][lookup_idx];
-        if (candidate == NULL || lookup == NULL) {
-            break;
-        }
-        if (candidate->virtual_key_position == lookup->virtual_key_position) {
-            candidates[matches] = candidates[candidate_idx];
-            matches++;
-            candidate_idx++;
-            lookup_idx++;
-        } else if (candidate->key_position_len > lookup->key_position_len) {
-            lookup_idx++;
-        } else if (candidate->key_position_len < lookup->key_position_len) {
-            candidate_idx++;
-        } else if (candidate->virtual_key_position > lookup->virtual_key_position) {
-            lookup_idx++;
-        } else if (candidate->virtual_key_position < lookup->virtual_key_position) {
-            candidate_idx++;
-        }
+    for (int w = 0; w < COMBO_SET_WORDS; w++) {
+        candidates[w] &= combo_lookup[position][w];
     }
-    // clear unmatched candidates
-    for (int i = matches; i < CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY; i++) {
-        candidates[i].combo = NULL;
-    }
-    // LOG_DBG("combo matches after filter %d", matches);
-    return matches;
+    // LOG_DBG("combo matches after filter %d", count_candidates());
+    return count_candidates();
 }
 
 static int64_t first_candidate_timeout() {
-    int64_t first_timeout = LONG_MAX;
-    for (int i = 0; i < CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY; i++) {
-        if (candidates[i].combo == NULL) {
-            break;
-        }
-        if (candidates[i].timeout_at < first_timeout) {
-            first_timeout = candidates[i].timeout_at;
+    int64_t first_timeout = LLONG_MAX;
+    FOR_EACH_COMBO_IN_SET(candidates, idx) {
+        int64_t timeout_at = candidate_timeout(idx);
+        if (timeout_at < first_timeout) {
+            first_timeout = timeout_at;
         }
     }
     return first_timeout;
 }
 
-static inline bool candidate_is_completely_pressed(struct combo_cfg *candidate) {
+static inline bool candidate_is_completely_pressed(const struct combo_cfg *candidate) {
     // this code assumes set(pressed_keys) <= set(candidate->key_positions)
     // this invariant is enforced by filter_candidates
     // since events may have been reraised after clearing one or more slots at
@@ -219,29 +281,14 @@ static inline bool candidate_is_completely_pressed(struct combo_cfg *candidate)
 static int cleanup();
 
 static int filter_timed_out_candidates(int64_t timestamp) {
-    int remaining_candidates = 0;
-    for (int i = 0; i < CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY; i++) {
-        struct combo_candidate *candidate = &candidates[i];
-        if (candidate->combo == NULL) {
-            break;
-        }
-        if (candidate->timeout_at > timestamp) {
-            bool need_to_bubble_up = remaining_candidates != i;
-            if (need_to_bubble_up) {
-                // bubble up => reorder candidates so they're contiguous
-                candidates[remaining_candidates].combo = candidate->combo;
-                candidates[remaining_candidates].timeout_at = candidate->timeout_at;
-                // clear the previous location
-                candidates[i].combo = NULL;
-                candidates[i].timeout_at = 0;
-            }
-
-            remaining_candidates++;
-        } else {
-            candidate->combo = NULL;
+    FOR_EACH_COMBO_IN_SET(candidates, idx) {
+        if (candidate_timeout(idx) <= timestamp) {
+            WRITE_BIT(candidates[idx / 32], idx % 32, 0);
         }
     }
 
+    int remaining_candidates = count_candidates();
+
     LOG_DBG(
         "after filtering out timed out combo candidates: remaining_candidates=%d timestamp=%lld",
         remaining_candidates, timestamp);
@@ -249,18 +296,10 @@ static int filter_timed_out_candidates(int64_t timestamp) {
     return remaining_candidates;
 }
 
-static int clear_candidates() {
-    for (int i = 0; i < CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY; i++) {
-        if (candidates[i].combo == NULL) {
-            return i;
-        }
-        candidates[i].combo = NULL;
-    }
-    return CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY;
-}
+static void clear_candidates() { memset(candidates, 0, sizeof(candidates)); }
 
 static int capture_pressed_key(const struct zmk_position_state_changed *ev) {
-    if (pressed_keys_count == CONFIG_ZMK_COMBO_MAX_COMBOS_PER_KEY) {
+    if (pressed_keys_count == ARRAY_SIZE(pressed_keys)) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
@@ -288,7 +327,7 @@ static int release_pressed_keys() {
     return count;
 }
 
-static inline int press_combo_behavior(struct combo_cfg *combo, int32_t timestamp) {
+static inline int press_combo_behavior(const struct combo_cfg *combo, int32_t timestamp) {
     struct zmk_behavior_binding_event event = {
         .position = combo->virtual_key_position,
         .timestamp = timestamp,
@@ -302,7 +341,7 @@ static inline int press_combo_behavior(struct combo_cfg *combo, int32_t timestam
     return zmk_behavior_invoke_binding(&combo->behavior, event, true);
 }
 
-static inline int release_combo_behavior(struct combo_cfg *combo, int32_t timestamp) {
+static inline int release_combo_behavior(const struct combo_cfg *combo, int32_t timestamp) {
     struct zmk_behavior_binding_event event = {
         .position = combo->virtual_key_position,
         .timestamp = timestamp,
@@ -330,7 +369,7 @@ static void move_pressed_keys_to_active_combo(struct active_combo *active_combo)
     pressed_keys_count -= combo_length;
 }
 
-static struct active_combo *store_active_combo(struct combo_cfg *combo) {
+static struct active_combo *store_active_combo(const struct combo_cfg *combo) {
     for (int i = 0; i < CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS; i++) {
         if (active_combos[i].combo == NULL) {
             active_combos[i].combo = combo;
@@ -344,7 +383,7 @@ static struct active_combo *store_active_combo(struct combo_cfg *combo) {
     return NULL;
 }
 
-static void activate_combo(struct combo_cfg *combo) {
+static void activate_combo(const struct combo_cfg *combo) {
     struct active_combo *active_combo = store_active_combo(combo);
     if (active_combo == NULL) {
         // unable to store combo
@@ -401,7 +440,8 @@ static bool release_combo_key(int32_t position, int64_t timestamp) {
 }
 
 static int cleanup() {
-    k_work_cancel_delayable(&timeout_task);
+    zmk_behavior_timer_stop(&timeout_timer);
+    timeout_timer_expires_at = 0;
     clear_candidates();
     if (fully_pressed_combo != NULL) {
         activate_combo(fully_pressed_combo);
@@ -410,24 +450,23 @@ static int cleanup() {
     return release_pressed_keys();
 }
 
-static void update_timeout_task() {
+static void update_timeout_timer() {
     int64_t first_timeout = first_candidate_timeout();
-    if (timeout_task_timeout_at == first_timeout) {
+    if (timeout_timer_expires_at == first_timeout) {
         return;
     }
     if (first_timeout == LLONG_MAX) {
-        timeout_task_timeout_at = 0;
-        k_work_cancel_delayable(&timeout_task);
+        timeout_timer_expires_at = 0;
+        zmk_behavior_timer_stop(&timeout_timer);
         return;
     }
-    if (k_work_schedule(&timeout_task, K_MSEC(first_timeout - k_uptime_get())) >= 0) {
-        timeout_task_timeout_at = first_timeout;
-    }
+    zmk_behavior_timer_start(&timeout_timer, first_timeout);
+    timeout_timer_expires_at = first_timeout;
 }
 
 static int position_state_down(const zmk_event_t *ev, struct zmk_position_state_changed *data) {
     int num_candidates;
-    if (candidates[0].combo == NULL) {
+    if (first_candidate() < 0) {
         num_candidates = setup_candidates_for_first_keypress(data->position, data->timestamp);
         if (num_candidates == 0) {
             return ZMK_EV_EVENT_BUBBLE;
@@ -436,9 +475,9 @@ static int position_state_down(const zmk_event_t *ev, struct zmk_position_state_
         filter_timed_out_candidates(data->timestamp);
         num_candidates = filter_candidates(data->position);
     }
-    update_timeout_task();
+    update_timeout_timer();
 
-    struct combo_cfg *candidate_combo = candidates[0].combo;
+    const struct combo_cfg *candidate_combo = num_candidates > 0 ? combos[first_candidate()] : NULL;
     LOG_DBG("combo: capturing position event %d", data->position);
     int ret = capture_pressed_key(data);
     switch (num_candidates) {
@@ -475,15 +514,13 @@ static int position_state_up(const zmk_event_t *ev, struct zmk_position_state_ch
     return ZMK_EV_EVENT_BUBBLE;
 }
 
-static void combo_timeout_handler(struct k_work *item) {
-    if (timeout_task_timeout_at == 0 || k_uptime_get() < timeout_task_timeout_at) {
-        // timer was cancelled or rescheduled.
-        return;
-    }
-    if (filter_timed_out_candidates(timeout_task_timeout_at) == 0) {
+static void combo_timeout_handler(struct zmk_behavior_timer *timer) {
+    int64_t timeout_at = timeout_timer_expires_at;
+    timeout_timer_expires_at = 0;
+    if (filter_timed_out_candidates(timeout_at) == 0) {
         cleanup();
     }
-    update_timeout_task();
+    update_timeout_timer();
 }
 
 static int position_state_changed_listener(const zmk_event_t *ev) {
@@ -520,26 +557,9 @@ ZMK_LISTENER(combo, behavior_combo_listener);
 ZMK_SUBSCRIPTION(combo, zmk_position_state_changed);
 ZMK_SUBSCRIPTION(combo, zmk_keycode_state_changed);
 
-#define COMBO_INST(n)                                                                              \
-    static struct combo_cfg combo_config_##n = {                                                   \
-        .timeout_ms = DT_PROP(n, timeout_ms),                                                      \
-        .require_prior_idle_ms = DT_PROP(n, require_prior_idle_ms),                                \
-        .key_positions = DT_PROP(n, key_positions),                                                \
-        .key_position_len = DT_PROP_LEN(n, key_positions),                                         \
-        .behavior = ZMK_KEYMAP_EXTRACT_BINDING(0, n),                                              \
-        .virtual_key_position = ZMK_VIRTUAL_KEY_POSITION_COMBO(__COUNTER__),                       \
-        .slow_release = DT_PROP(n, slow_release),                                                  \
-        .layers = DT_PROP(n, layers),                                                              \
-        .layers_len = DT_PROP_LEN(n, layers),                                                      \
-    };
-
-#define INITIALIZE_COMBO(n) initialize_combo(&combo_config_##n);
-
-DT_INST_FOREACH_CHILD(0, COMBO_INST)
-
 static int combo_init(void) {
-    k_work_init_delayable(&timeout_task, combo_timeout_handler);
-    DT_INST_FOREACH_CHILD(0, INITIALIZE_COMBO);
+    zmk_behavior_timer_init(&timeout_timer, combo_timeout_handler);
+    initialize_combo_lookups();
     return 0;
 }
 
@@ -30,15 +30,13 @@ struct conditional_layer_cfg {
     zmk_keymap_layers_state_t if_layers_state_mask;
 
     // The layer number that should be active while all layers in the if-layers mask are active.
-    int8_t then_layer;
+    zmk_keymap_layer_id_t then_layer;
 };
 
-#define IF_LAYER_BIT(node_id, prop, idx) BIT(DT_PROP_BY_IDX(node_id, prop, idx)) |
-
 // Evaluates to conditional_layer_cfg struct initializer.
 #define CONDITIONAL_LAYER_DECL(n)                                                                  \
     {                                                                                              \
-        .if_layers_state_mask = DT_FOREACH_PROP_ELEM(n, if_layers, IF_LAYER_BIT) 0,                \
+        .if_layers_state_mask = ZMK_KEYMAP_LAYERS_STATE_DT_PROP(n, if_layers),                     \
         .then_layer = DT_PROP(n, then_layer),                                                      \
     },
 
@@ -49,7 +47,7 @@ static const struct conditional_layer_cfg CONDITIONAL_LAYER_CFGS[] = {
 static const int32_t NUM_CONDITIONAL_LAYER_CFGS =
     sizeof(CONDITIONAL_LAYER_CFGS) / sizeof(*CONDITIONAL_LAYER_CFGS);
 
-static void conditional_layer_activate(int8_t layer) {
+static void conditional_layer_activate(zmk_keymap_layer_id_t layer) {
     // This may trigger another event that could, in turn, activate additional then-layers. However,
     // the process will eventually terminate (at worst, when every layer is active).
     if (!zmk_keymap_layer_active(layer)) {
@@ -58,7 +56,7 @@ static void conditional_layer_activate(int8_t layer) {
     }
 }
 
-static void conditional_layer_deactivate(int8_t layer) {
+static void conditional_layer_deactivate(zmk_keymap_layer_id_t layer) {
     // This may deactivate a then-layer that's already active via another mechanism (e.g., a
     // momentary layer behavior). However, the same problem arises when multiple keys with the same
     // &mo binding are held and then one is released, so it's probably not an issue in practice.
@@ -81,9 +79,9 @@ static int layer_state_changed_listener(const zmk_event_t *ev) {
     }
 
     while (conditional_layer_updates_needed) {
-        int8_t max_then_layer = -1;
-        uint32_t then_layers = 0;
-        uint32_t then_layer_state = 0;
+        int max_then_layer = -1;
+        zmk_keymap_layers_state_t then_layers = {0};
+        zmk_keymap_layers_state_t then_layer_state = {0};
 
         conditional_layer_updates_needed = false;
 
@@ -91,21 +89,21 @@ static int layer_state_changed_listener(const zmk_event_t *ev) {
         // in the config should activate based on the currently active set of if-layers.
         for (int i = 0; i < NUM_CONDITIONAL_LAYER_CFGS; i++) {
             const struct conditional_layer_cfg *cfg = CONDITIONAL_LAYER_CFGS + i;
-            zmk_keymap_layers_state_t mask = cfg->if_layers_state_mask;
-            then_layers |= BIT(cfg->then_layer);
+            zmk_keymap_layers_state_write(&then_layers, cfg->then_layer, true);
             max_then_layer = MAX(max_then_layer, cfg->then_layer);
 
             // Activate then-layer if and only if all if-layers are already active. Note that we
             // reevaluate the current layer state for each config since activation of one layer can
             // also trigger activation of another.
-            if ((zmk_keymap_layer_state() & mask) == mask) {
-                then_layer_state |= BIT(cfg->then_layer);
+            if (zmk_keymap_layers_state_contains(zmk_keymap_layer_state(),
+                                                 cfg->if_layers_state_mask)) {
+                zmk_keymap_layers_state_write(&then_layer_state, cfg->then_layer, true);
             }
         }
 
-        for (uint8_t layer = 0; layer <= max_then_layer; layer++) {
-            if ((BIT(layer) & then_layers) != 0U) {
-                if ((BIT(layer) & then_layer_state) != 0U) {
+        for (int layer = 0; layer <= max_then_layer; layer++) {
+            if (zmk_keymap_layers_state_test(then_layers, layer)) {
+                if (zmk_keymap_layers_state_test(then_layer_state, layer)) {
                     conditional_layer_activate(layer);
                 } else {
                     conditional_layer_deactivate(layer);
@@ -20,6 +20,10 @@
 #include <zmk/events/usb_conn_state_changed.h>
 #include <zmk/events/endpoint_changed.h>
 
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+#include <zmk/latency_probe.h>
+#endif
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -126,6 +130,11 @@ static int send_keyboard_report(void) {
         if (err) {
             LOG_ERR("FAILED TO SEND OVER USB: %d", err);
         }
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE) && !IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+        else {
+            zmk_latency_probe_record(ZMK_TRANSPORT_USB, zmk_latency_probe_get_origin());
+        }
+#endif
         return err;
 #else
         LOG_ERR("USB endpoint is not supported");
@@ -160,6 +169,11 @@ static int send_consumer_report(void) {
         if (err) {
             LOG_ERR("FAILED TO SEND OVER USB: %d", err);
         }
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE) && !IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+        else {
+            zmk_latency_probe_record(ZMK_TRANSPORT_USB, zmk_latency_probe_get_origin());
+        }
+#endif
         return err;
 #else
         LOG_ERR("USB endpoint is not supported");
@@ -186,8 +200,7 @@ static int send_consumer_report(void) {
     return -ENOTSUP;
 }
 
-int zmk_endpoints_send_report(uint16_t usage_page) {
-
+static int send_report(uint16_t usage_page) {
     LOG_DBG("usage page 0x%02X", usage_page);
     switch (usage_page) {
     case HID_USAGE_KEY:
@@ -201,8 +214,107 @@ int zmk_endpoints_send_report(uint16_t usage_page) {
     return -ENOTSUP;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_COALESCE_REPORTS)
+
+#define PENDING_KEYBOARD_REPORT BIT(0)
+#define PENDING_CONSUMER_REPORT BIT(1)
+
+static uint8_t pending_reports;
+
+// Whether the pending reports hold a key press or key releases. They never hold both, since a key
+// that is pressed and released before its report is sent would never reach the host. They also
+// never hold more than one press: NKRO hosts order the keys pressed in one report by usage ID, so
+// a roll would arrive out of order.
+static bool pending_reports_pressed;
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+// The origin of the first key event that changed the pending reports.
+static uint32_t pending_reports_origin;
+#endif
+
+static void send_pending_reports_work_handler(struct k_work *work) {
+    zmk_endpoints_send_pending_reports();
+}
+
+static K_WORK_DEFINE(send_pending_reports_work, send_pending_reports_work_handler);
+
+int zmk_endpoints_send_report(uint16_t usage_page) {
+    switch (usage_page) {
+    case HID_USAGE_KEY:
+        pending_reports |= PENDING_KEYBOARD_REPORT;
+        break;
+
+    case HID_USAGE_CONSUMER:
+        pending_reports |= PENDING_CONSUMER_REPORT;
+        break;
+
+    default:
+        LOG_ERR("Unsupported usage page %d", usage_page);
+        return -ENOTSUP;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    if (pending_reports_origin == 0) {
+        pending_reports_origin = zmk_latency_probe_get_origin();
+    }
+#endif
+
+    // Key events are only handled on the system work queue, which Kconfig enforces for split
+    // centrals, so this runs once the work item that raised the current burst of events is done.
+    k_work_submit(&send_pending_reports_work);
+    return 0;
+}
+
+void zmk_endpoints_prepare_report_change(bool pressed) {
+    if (pending_reports != 0 && (pressed || pending_reports_pressed)) {
+        zmk_endpoints_send_pending_reports();
+    }
+
+    pending_reports_pressed = pressed;
+}
+
+int zmk_endpoints_send_pending_reports(void) {
+    int ret = 0;
+    uint8_t reports = pending_reports;
+    pending_reports = 0;
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    uint32_t previous_origin = zmk_latency_probe_set_origin(pending_reports_origin);
+    pending_reports_origin = 0;
+#endif
+
+    // Modifiers for consumer keys are in the keyboard report, so it always goes first.
+    if (reports & PENDING_KEYBOARD_REPORT) {
+        ret = send_report(HID_USAGE_KEY);
+    }
+
+    if (reports & PENDING_CONSUMER_REPORT) {
+        int err = send_report(HID_USAGE_CONSUMER);
+        ret = ret < 0 ? ret : err;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    zmk_latency_probe_set_origin(previous_origin);
+#endif
+
+    return ret;
+}
+
+#else
+
+int zmk_endpoints_send_report(uint16_t usage_page) { return send_report(usage_page); }
+
+void zmk_endpoints_prepare_report_change(bool pressed) {}
+
+int zmk_endpoints_send_pending_reports(void) { return 0; }
+
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_COALESCE_REPORTS)
+
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_endpoints_send_mouse_report() {
+    // Modifiers held for a click have to reach the host before the click itself.
+    zmk_endpoints_send_pending_reports();
+
     switch (current_instance.transport) {
     case ZMK_TRANSPORT_USB: {
 #if IS_ENABLED(CONFIG_ZMK_USB)
@@ -330,6 +442,8 @@ static int zmk_endpoints_init(void) {
 }
 
 void zmk_endpoints_clear_current(void) {
+    zmk_endpoints_prepare_report_change(false);
+
     zmk_hid_keyboard_clear();
     zmk_hid_consumer_clear();
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
@@ -338,6 +452,9 @@ void zmk_endpoints_clear_current(void) {
 
     zmk_endpoints_send_report(HID_USAGE_KEY);
     zmk_endpoints_send_report(HID_USAGE_CONSUMER);
+
+    // The endpoint may be about to change, so the cleared reports can't wait for the next flush.
+    zmk_endpoints_send_pending_reports();
 }
 
 static void update_current_endpoint(void) {
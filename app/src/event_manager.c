@@ -5,7 +5,9 @@
  */
 
 #include <zephyr/kernel.h>
+#include <zephyr/init.h>
 #include <zephyr/logging/log.h>
+#include <string.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -17,16 +19,68 @@ extern struct zmk_event_type *__event_type_end[];
 extern struct zmk_event_subscription __event_subscriptions_start[];
 extern struct zmk_event_subscription __event_subscriptions_end[];
 
-int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+
+#if IS_ENABLED(CONFIG_ARCH_POSIX) && IS_ENABLED(CONFIG_EXTERNAL_LIBC)
+
+#include <time.h>
+
+// Simulated time stands still while code runs on native_posix, so listeners are timed with the host
+// CPU clock, in nanoseconds, instead.
+static uint32_t stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint32_t)(ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec);
+}
+
+uint32_t zmk_event_manager_stats_cycles_to_us(uint64_t cycles) {
+    return (uint32_t)(cycles / NSEC_PER_USEC);
+}
+
+#else
+
+static inline uint32_t stats_now(void) { return k_cycle_get_32(); }
+
+uint32_t zmk_event_manager_stats_cycles_to_us(uint64_t cycles) {
+    return (uint32_t)k_cyc_to_us_floor64(cycles);
+}
+
+#endif
+
+static uint8_t stats_bucket(uint32_t cycles) {
+    uint32_t us = zmk_event_manager_stats_cycles_to_us(cycles);
+    uint8_t bucket = (us == 0) ? 0 : 32 - __builtin_clz(us);
+
+    return MIN(bucket, ZMK_EVENT_MANAGER_STATS_BUCKETS - 1);
+}
+
+static int invoke_listener(struct zmk_event_dispatch_slot *slot, const zmk_event_t *event) {
+    // Timings are inclusive of any events raised synchronously by the listener itself.
+    uint32_t start = stats_now();
+    int ret = slot->listener->callback(event);
+    uint32_t elapsed = stats_now() - start;
+
+    slot->stats.calls++;
+    slot->stats.total_cycles += elapsed;
+    slot->stats.max_cycles = MAX(slot->stats.max_cycles, elapsed);
+
+    return ret;
+}
+
+#else
+
+static inline int invoke_listener(struct zmk_event_dispatch_slot *slot, const zmk_event_t *event) {
+    return slot->listener->callback(event);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+
+static int handle_from(zmk_event_t *event, uint8_t start_index) {
     int ret = 0;
-    uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
-    for (int i = start_index; i < len; i++) {
-        struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
-        if (ev_sub->event_type != event->event) {
-            continue;
-        }
+    struct zmk_event_subscribers *subs = event->event->subscribers;
+    for (int i = start_index; i < subs->len; i++) {
         event->last_listener_index = i;
-        ret = ev_sub->listener->callback(event);
+        ret = invoke_listener(&subs->slots[i], event);
         switch (ret) {
         case ZMK_EV_EVENT_BUBBLE:
             continue;
@@ -35,6 +89,9 @@ int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
             return 0;
         case ZMK_EV_EVENT_CAPTURED:
             LOG_DBG("Listener captured the event");
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+            subs->stats.captured++;
+#endif
             return 0;
         default:
             LOG_DBG("Listener returned an error: %d", ret);
@@ -45,38 +102,199 @@ int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
     return 0;
 }
 
-int zmk_event_manager_raise(zmk_event_t *event) { return zmk_event_manager_handle_from(event, 0); }
+int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    struct zmk_event_type_stats *stats = &event->event->subscribers->stats;
+    uint32_t start = stats_now();
+    int ret = handle_from(event, start_index);
 
-int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener) {
-    uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
-    for (int i = 0; i < len; i++) {
-        struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
+    stats->histogram[stats_bucket(stats_now() - start)]++;
+
+    return ret;
+#else
+    return handle_from(event, start_index);
+#endif
+}
+
+static int find_listener_index(const zmk_event_t *event, const struct zmk_listener *listener) {
+    const struct zmk_event_subscribers *subs = event->event->subscribers;
+
+    // Events re-raised after being captured or copied by a listener still carry the index of
+    // that listener, so the common case needs no search at all.
+    if (event->last_listener_index < subs->len &&
+        subs->slots[event->last_listener_index].listener == listener) {
+        return event->last_listener_index;
+    }
 
-        if (ev_sub->event_type == event->event && ev_sub->listener == listener) {
-            return zmk_event_manager_handle_from(event, i + 1);
+    for (int i = 0; i < subs->len; i++) {
+        if (subs->slots[i].listener == listener) {
+            return i;
         }
     }
 
-    LOG_WRN("Unable to find where to raise this after event");
+    return -ENOENT;
+}
+
+int zmk_event_manager_raise(zmk_event_t *event) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    event->event->subscribers->stats.raised++;
+#endif
 
-    return -EINVAL;
+    return zmk_event_manager_handle_from(event, 0);
 }
 
-int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *listener) {
-    uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
-    for (int i = 0; i < len; i++) {
-        struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
+int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener) {
+    int index = find_listener_index(event, listener);
+    if (index < 0) {
+        LOG_WRN("Unable to find where to raise this after event");
+        return -EINVAL;
+    }
 
-        if (ev_sub->event_type == event->event && ev_sub->listener == listener) {
-            return zmk_event_manager_handle_from(event, i);
-        }
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    event->event->subscribers->stats.reraised++;
+#endif
+
+    return zmk_event_manager_handle_from(event, index + 1);
+}
+
+int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *listener) {
+    int index = find_listener_index(event, listener);
+    if (index < 0) {
+        LOG_WRN("Unable to find where to raise this event");
+        return -EINVAL;
     }
 
-    LOG_WRN("Unable to find where to raise this event");
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    event->event->subscribers->stats.reraised++;
+#endif
 
-    return -EINVAL;
+    return zmk_event_manager_handle_from(event, index);
 }
 
 int zmk_event_manager_release(zmk_event_t *event) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    event->event->subscribers->stats.released++;
+#endif
+
     return zmk_event_manager_handle_from(event, event->last_listener_index + 1);
 }
+
+static int event_manager_init(void) {
+    ptrdiff_t slot_count;
+    STRUCT_SECTION_COUNT(zmk_event_dispatch_slot, &slot_count);
+
+    size_t sub_count = __event_subscriptions_end - __event_subscriptions_start;
+    if (slot_count != sub_count || sub_count > UINT8_MAX) {
+        LOG_ERR("Mismatched event subscription tables (%d slots, %d subscriptions)",
+                (int)slot_count, (int)sub_count);
+        return -EINVAL;
+    }
+
+    // Group the subscriptions by event type, preserving link order within each type so listener
+    // priority is unchanged.
+    int next_slot = 0;
+    for (struct zmk_event_type **type = __event_type_start; type < __event_type_end; type++) {
+        struct zmk_event_subscribers *subs = (*type)->subscribers;
+        struct zmk_event_dispatch_slot *slots;
+
+        STRUCT_SECTION_GET(zmk_event_dispatch_slot, next_slot, &slots);
+        subs->slots = slots;
+        subs->len = 0;
+
+        for (struct zmk_event_subscription *ev_sub = __event_subscriptions_start;
+             ev_sub < __event_subscriptions_end; ev_sub++) {
+            if (ev_sub->event_type == *type) {
+                slots[subs->len++].listener = ev_sub->listener;
+            }
+        }
+
+        next_slot += subs->len;
+    }
+
+    return 0;
+}
+
+SYS_INIT(event_manager_init, PRE_KERNEL_1, 0);
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+
+void zmk_event_manager_stats_foreach(zmk_event_manager_stats_cb cb, void *user_data) {
+    for (struct zmk_event_type **type = __event_type_start; type < __event_type_end; type++) {
+        const struct zmk_event_subscribers *subs = (*type)->subscribers;
+
+        for (int i = 0; i < subs->len; i++) {
+            cb(*type, &subs->stats, subs->slots[i].listener, &subs->slots[i].stats, user_data);
+        }
+    }
+}
+
+void zmk_event_manager_stats_log(void) {
+    for (struct zmk_event_type **type = __event_type_start; type < __event_type_end; type++) {
+        const struct zmk_event_subscribers *subs = (*type)->subscribers;
+        const struct zmk_event_type_stats *stats = &subs->stats;
+
+        if (stats->raised == 0) {
+            continue;
+        }
+
+        LOG_INF("%s: raised %d, captured %d, released %d, re-raised %d", (*type)->name,
+                stats->raised, stats->captured, stats->released, stats->reraised);
+
+        for (int b = 0; b < ZMK_EVENT_MANAGER_STATS_BUCKETS; b++) {
+            if (stats->histogram[b] == 0) {
+                continue;
+            }
+
+            if (b == ZMK_EVENT_MANAGER_STATS_BUCKETS - 1) {
+                LOG_INF("  >= %dus: %d", 1 << (b - 1), stats->histogram[b]);
+            } else {
+                LOG_INF("  < %dus: %d", 1 << b, stats->histogram[b]);
+            }
+        }
+
+        for (int i = 0; i < subs->len; i++) {
+            const struct zmk_event_dispatch_slot *slot = &subs->slots[i];
+
+            if (slot->stats.calls == 0) {
+                continue;
+            }
+
+            LOG_INF("  %s: %d calls, avg %dus, max %dus", slot->listener->name, slot->stats.calls,
+                    zmk_event_manager_stats_cycles_to_us(slot->stats.total_cycles /
+                                                         slot->stats.calls),
+                    zmk_event_manager_stats_cycles_to_us(slot->stats.max_cycles));
+        }
+    }
+}
+
+void zmk_event_manager_stats_reset(void) {
+    for (struct zmk_event_type **type = __event_type_start; type < __event_type_end; type++) {
+        struct zmk_event_subscribers *subs = (*type)->subscribers;
+
+        memset(&subs->stats, 0, sizeof(subs->stats));
+        for (int i = 0; i < subs->len; i++) {
+            memset(&subs->slots[i].stats, 0, sizeof(subs->slots[i].stats));
+        }
+    }
+}
+
+#if CONFIG_ZMK_EVENT_MANAGER_STATS_LOG_INTERVAL_SEC > 0
+
+static void stats_log_work_cb(struct k_work *work) {
+    zmk_event_manager_stats_log();
+    k_work_schedule(k_work_delayable_from_work(work),
+                    K_SECONDS(CONFIG_ZMK_EVENT_MANAGER_STATS_LOG_INTERVAL_SEC));
+}
+
+static K_WORK_DELAYABLE_DEFINE(stats_log_work, stats_log_work_cb);
+
+static int event_manager_stats_init(void) {
+    k_work_schedule(&stats_log_work, K_SECONDS(CONFIG_ZMK_EVENT_MANAGER_STATS_LOG_INTERVAL_SEC));
+    return 0;
+}
+
+SYS_INIT(event_manager_stats_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif // CONFIG_ZMK_EVENT_MANAGER_STATS_LOG_INTERVAL_SEC > 0
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
@@ -477,3 +477,98 @@ struct zmk_hid_consumer_report *zmk_hid_get_consumer_report(void) { return &cons
 struct zmk_hid_mouse_report *zmk_hid_get_mouse_report(void) { return &mouse_report; }
 
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
+#define REPORT_CHANGE_PRESS BIT(0)
+#define REPORT_CHANGE_RELEASE BIT(1)
+
+static uint8_t flags_change(uint8_t from, uint8_t to) {
+    return ((to & ~from) ? REPORT_CHANGE_PRESS : 0) | ((from & ~to) ? REPORT_CHANGE_RELEASE : 0);
+}
+
+// Usage arrays are packed, so 16-bit usages may not be aligned. Zero marks an unused slot.
+static zmk_key_t usage_at(const void *usages, size_t usage_size, size_t index) {
+    if (usage_size == sizeof(uint8_t)) {
+        return ((const uint8_t *)usages)[index];
+    }
+
+    return UNALIGNED_GET(&((const uint16_t *)usages)[index]);
+}
+
+static bool usages_contain(const void *usages, size_t usage_size, size_t count, zmk_key_t usage) {
+    for (size_t i = 0; i < count; i++) {
+        if (usage_at(usages, usage_size, i) == usage) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint8_t usages_change(const void *from, const void *to, size_t usage_size, size_t count) {
+    uint8_t change = 0;
+    for (size_t i = 0; i < count; i++) {
+        zmk_key_t pressed = usage_at(to, usage_size, i);
+        if (pressed != 0 && !usages_contain(from, usage_size, count, pressed)) {
+            change |= REPORT_CHANGE_PRESS;
+        }
+
+        zmk_key_t released = usage_at(from, usage_size, i);
+        if (released != 0 && !usages_contain(to, usage_size, count, released)) {
+            change |= REPORT_CHANGE_RELEASE;
+        }
+    }
+
+    return change;
+}
+
+// Skipping the pending report merges both changes into one. That is only safe if they go the same
+// way, otherwise a key could be pressed and released again (or the other way around) unseen. The
+// next change must not press anything either, since NKRO hosts order the keys pressed in one report
+// by usage ID and a roll would arrive out of order.
+static bool is_skippable(uint8_t change_to_pending, uint8_t change_to_next) {
+    return !(change_to_next & REPORT_CHANGE_PRESS) &&
+           (change_to_pending | change_to_next) != (REPORT_CHANGE_PRESS | REPORT_CHANGE_RELEASE);
+}
+
+bool zmk_hid_keyboard_report_body_is_skippable(const struct zmk_hid_keyboard_report_body *prev,
+                                               const struct zmk_hid_keyboard_report_body *pending,
+                                               const struct zmk_hid_keyboard_report_body *next) {
+    uint8_t change_to_pending = flags_change(prev->modifiers, pending->modifiers);
+    uint8_t change_to_next = flags_change(pending->modifiers, next->modifiers);
+
+#if IS_ENABLED(CONFIG_ZMK_HID_SEPARATE_MOD_RELEASE_REPORT)
+    // Modifier releases get a report of their own on purpose.
+    if (change_to_next & REPORT_CHANGE_RELEASE) {
+        return false;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_HID_SEPARATE_MOD_RELEASE_REPORT)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_NKRO)
+    for (size_t i = 0; i < ARRAY_SIZE(prev->keys); i++) {
+        change_to_pending |= flags_change(prev->keys[i], pending->keys[i]);
+        change_to_next |= flags_change(pending->keys[i], next->keys[i]);
+    }
+#elif IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
+    change_to_pending |=
+        usages_change(prev->keys, pending->keys, sizeof(prev->keys[0]), ARRAY_SIZE(prev->keys));
+    change_to_next |=
+        usages_change(pending->keys, next->keys, sizeof(prev->keys[0]), ARRAY_SIZE(prev->keys));
+#endif
+
+    return is_skippable(change_to_pending, change_to_next);
+}
+
+bool zmk_hid_consumer_report_body_is_skippable(const struct zmk_hid_consumer_report_body *prev,
+                                               const struct zmk_hid_consumer_report_body *pending,
+                                               const struct zmk_hid_consumer_report_body *next) {
+    uint8_t change_to_pending =
+        usages_change(prev->keys, pending->keys, sizeof(prev->keys[0]), ARRAY_SIZE(prev->keys));
+    uint8_t change_to_next =
+        usages_change(pending->keys, next->keys, sizeof(prev->keys[0]), ARRAY_SIZE(prev->keys));
+
+    return is_skippable(change_to_pending, change_to_next);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
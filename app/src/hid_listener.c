@@ -16,6 +16,10 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <dt-bindings/zmk/hid_usage_pages.h>
 #include <zmk/endpoints.h>
 
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+#include <zmk/latency_probe.h>
+#endif
+
 static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *ev) {
     int err, explicit_mods_changed, implicit_mods_changed;
 
@@ -23,6 +27,7 @@ static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *
         zmk_hid_is_pressed(ZMK_HID_USAGE(ev->usage_page, ev->keycode))) {
         LOG_DBG("unregistering usage_page 0x%02X keycode 0x%02X since it was already pressed",
                 ev->usage_page, ev->keycode);
+        zmk_endpoints_prepare_report_change(false);
         err = zmk_hid_release(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
         if (err < 0) {
             LOG_DBG("Unable to pre-release keycode (%d)", err);
@@ -36,6 +41,8 @@ static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *
 
     LOG_DBG("usage_page 0x%02X keycode 0x%02X implicit_mods 0x%02X explicit_mods 0x%02X",
             ev->usage_page, ev->keycode, ev->implicit_modifiers, ev->explicit_modifiers);
+    zmk_endpoints_prepare_report_change(true);
+
     err = zmk_hid_press(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
     if (err < 0) {
         LOG_DBG("Unable to press keycode");
@@ -60,6 +67,7 @@ static int hid_listener_keycode_released(const struct zmk_keycode_state_changed
 
     LOG_DBG("usage_page 0x%02X keycode 0x%02X implicit_mods 0x%02X explicit_mods 0x%02X",
             ev->usage_page, ev->keycode, ev->implicit_modifiers, ev->explicit_modifiers);
+    zmk_endpoints_prepare_report_change(false);
     err = zmk_hid_release(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
     if (err < 0) {
         LOG_DBG("Unable to release keycode");
@@ -75,6 +83,9 @@ static int hid_listener_keycode_released(const struct zmk_keycode_state_changed
         LOG_ERR("Failed to send key report for the released keycode (%d)", err);
     }
 
+    // The modifier release must not be coalesced into the same report as the key release.
+    zmk_endpoints_send_pending_reports();
+
 #endif // IS_ENABLED(CONFIG_ZMK_HID_SEPARATE_MOD_RELEASE_REPORT)
 
     explicit_mods_changed = zmk_hid_unregister_mods(ev->explicit_modifiers);
@@ -99,11 +110,17 @@ static int hid_listener_keycode_released(const struct zmk_keycode_state_changed
 int hid_listener(const zmk_event_t *eh) {
     const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
     if (ev) {
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        uint32_t previous_origin = zmk_latency_probe_set_origin(ev->probe_origin);
+#endif
         if (ev->state) {
             hid_listener_keycode_pressed(ev);
         } else {
             hid_listener_keycode_released(ev);
         }
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        zmk_latency_probe_set_origin(previous_origin);
+#endif
     }
     return 0;
 }
@@ -24,6 +24,9 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
 #include <zmk/hid_indicators.h>
 #endif // IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+#include <zmk/latency_probe.h>
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
 
 enum {
     HIDS_REMOTE_WAKE = BIT(0),
@@ -285,22 +288,165 @@ K_THREAD_STACK_DEFINE(hog_q_stack, CONFIG_ZMK_BLE_THREAD_STACK_SIZE);
 
 struct k_work_q hog_work_q;
 
-K_MSGQ_DEFINE(zmk_hog_keyboard_msgq, sizeof(struct zmk_hid_keyboard_report_body),
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
+// How many connection intervals to wait for a notification to go out before sending the next
+// report anyway, e.g. because the connection was lost.
+#define REPORT_SENT_TIMEOUT_INTERVALS 4
+
+// Only one report of each type is handed to the controller at a time. The next one is sent once
+// the previous one went out in a connection event, so reports that are superseded in the meantime
+// can still be skipped instead of piling up in the controller's buffers.
+static void wait_for_report_sent(struct bt_conn *conn, struct k_work_delayable *work) {
+    struct bt_conn_info info;
+    uint32_t timeout_ms = REPORT_SENT_TIMEOUT_INTERVALS * BT_GAP_INIT_CONN_INT_MAX * 5 / 4;
+    if (bt_conn_get_info(conn, &info) == 0) {
+        // Connection intervals are in units of 1.25 ms.
+        timeout_ms = REPORT_SENT_TIMEOUT_INTERVALS * info.le.interval * 5 / 4;
+    }
+
+    // Scheduled before sending, so a report that goes out right away can't race the timeout.
+    k_work_reschedule_for_queue(&hog_work_q, work, K_MSEC(timeout_ms));
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
+struct keyboard_queued_report {
+    struct zmk_hid_keyboard_report_body body;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    uint32_t probe_origin;
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+};
+
+K_MSGQ_DEFINE(zmk_hog_keyboard_msgq, sizeof(struct keyboard_queued_report),
               CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE, 4);
 
-void send_keyboard_report_callback(struct k_work *work) {
-    struct zmk_hid_keyboard_report_body report;
+static void send_keyboard_report_callback(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(hog_keyboard_work, send_keyboard_report_callback);
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
+// The report last taken off the queue to be sent, which the host sees before the queued ones.
+static struct zmk_hid_keyboard_report_body last_sent_keyboard_report;
+
+static void keyboard_report_sent(struct bt_conn *conn, void *user_data) {
+    k_work_reschedule_for_queue(&hog_work_q, &hog_keyboard_work, K_NO_WAIT);
+}
+
+static void skip_superseded_keyboard_reports(struct keyboard_queued_report *report) {
+    struct keyboard_queued_report next;
+    while (k_msgq_peek(&zmk_hog_keyboard_msgq, &next) == 0 &&
+           zmk_hid_keyboard_report_body_is_skippable(&last_sent_keyboard_report, &report->body,
+                                                     &next.body)) {
+        k_msgq_get(&zmk_hog_keyboard_msgq, &next, K_NO_WAIT);
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        if (report->probe_origin != 0) {
+            next.probe_origin = report->probe_origin;
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        *report = next;
+    }
+}
+
+// Takes the next report to send off the queue. The scheduler is locked meanwhile, so
+// queue_keyboard_report_when_full() always finds the report either queued or recorded as sent.
+static int take_keyboard_report(struct keyboard_queued_report *report) {
+    k_sched_lock();
+
+    int err = k_msgq_get(&zmk_hog_keyboard_msgq, report, K_NO_WAIT);
+    if (err == 0) {
+        skip_superseded_keyboard_reports(report);
+        last_sent_keyboard_report = report->body;
+    }
+
+    k_sched_unlock();
+    return err;
+}
+
+static struct keyboard_queued_report
+    compacted_keyboard_reports[CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE];
+
+// Leaves out the compacted reports that the next one supersedes and returns how many are left.
+static size_t compact_keyboard_reports(size_t count, struct keyboard_queued_report *next) {
+    while (count > 0) {
+        const struct zmk_hid_keyboard_report_body *prev =
+            count > 1 ? &compacted_keyboard_reports[count - 2].body : &last_sent_keyboard_report;
+        const struct zmk_hid_keyboard_report_body *pending =
+            &compacted_keyboard_reports[count - 1].body;
+        if (!zmk_hid_keyboard_report_body_is_skippable(prev, pending, &next->body)) {
+            break;
+        }
+
+        count--;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        if (compacted_keyboard_reports[count].probe_origin != 0) {
+            next->probe_origin = compacted_keyboard_reports[count].probe_origin;
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    }
+
+    return count;
+}
+
+// Makes room for a report in the full queue without dropping the older reports, which may hold a
+// press or release the host hasn't seen yet. Like when sending, reports that a later one
+// supersedes are left out. If none are, the newest state replaces the last queued report.
+static void queue_keyboard_report_when_full(const struct keyboard_queued_report *queued) {
+    struct keyboard_queued_report next;
+    size_t count = 0;
+
+    k_sched_lock();
+
+    while (k_msgq_get(&zmk_hog_keyboard_msgq, &next, K_NO_WAIT) == 0) {
+        count = compact_keyboard_reports(count, &next);
+        compacted_keyboard_reports[count++] = next;
+    }
+
+    next = *queued;
+    count = compact_keyboard_reports(count, &next);
+    if (count < ARRAY_SIZE(compacted_keyboard_reports)) {
+        compacted_keyboard_reports[count++] = next;
+    } else {
+        LOG_WRN("Keyboard report queue full, merged the report into the last queued one");
+        compacted_keyboard_reports[count - 1].body = next.body;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        k_msgq_put(&zmk_hog_keyboard_msgq, &compacted_keyboard_reports[i], K_NO_WAIT);
+    }
+
+    k_sched_unlock();
+}
 
-    while (k_msgq_get(&zmk_hog_keyboard_msgq, &report, K_NO_WAIT) == 0) {
+#else
+
+static int take_keyboard_report(struct keyboard_queued_report *report) {
+    return k_msgq_get(&zmk_hog_keyboard_msgq, report, K_NO_WAIT);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
+static void send_keyboard_report_callback(struct k_work *work) {
+    struct keyboard_queued_report report;
+
+    while (take_keyboard_report(&report) == 0) {
         struct bt_conn *conn = zmk_ble_active_profile_conn();
         if (conn == NULL) {
             return;
         }
 
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+        wait_for_report_sent(conn, &hog_keyboard_work);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
         struct bt_gatt_notify_params notify_params = {
             .attr = &hog_svc.attrs[5],
-            .data = &report,
-            .len = sizeof(report),
+            .data = &report.body,
+            .len = sizeof(report.body),
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+            .func = keyboard_report_sent,
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
         };
 
         int err = bt_gatt_notify_cb(conn, &notify_params);
@@ -309,22 +455,43 @@ void send_keyboard_report_callback(struct k_work *work) {
         } else if (err) {
             LOG_DBG("Error notifying %d", err);
         }
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        else {
+            zmk_latency_probe_record(ZMK_TRANSPORT_BLE, report.probe_origin);
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
 
         bt_conn_unref(conn);
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+        if (err == 0) {
+            return;
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
     }
 }
 
-K_WORK_DEFINE(hog_keyboard_work, send_keyboard_report_callback);
-
 int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_keyboard_msgq, report, K_MSEC(100));
+    struct keyboard_queued_report queued = {
+        .body = *report,
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        .probe_origin = zmk_latency_probe_get_origin(),
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    };
+
+    int err = k_msgq_put(&zmk_hog_keyboard_msgq, &queued, K_MSEC(100));
     if (err) {
         switch (err) {
         case -EAGAIN: {
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+            queue_keyboard_report_when_full(&queued);
+            break;
+#else
             LOG_WRN("Keyboard message queue full, popping first message and queueing again");
-            struct zmk_hid_keyboard_report_body discarded_report;
+            struct keyboard_queued_report discarded_report;
             k_msgq_get(&zmk_hog_keyboard_msgq, &discarded_report, K_NO_WAIT);
             return zmk_hog_send_keyboard_report(report);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
         }
         default:
             LOG_WRN("Failed to queue keyboard report to send (%d)", err);
@@ -332,27 +499,147 @@ int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *report) {
         }
     }
 
-    k_work_submit_to_queue(&hog_work_q, &hog_keyboard_work);
+    k_work_schedule_for_queue(&hog_work_q, &hog_keyboard_work, K_NO_WAIT);
 
     return 0;
 };
 
-K_MSGQ_DEFINE(zmk_hog_consumer_msgq, sizeof(struct zmk_hid_consumer_report_body),
+struct consumer_queued_report {
+    struct zmk_hid_consumer_report_body body;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    uint32_t probe_origin;
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+};
+
+K_MSGQ_DEFINE(zmk_hog_consumer_msgq, sizeof(struct consumer_queued_report),
               CONFIG_ZMK_BLE_CONSUMER_REPORT_QUEUE_SIZE, 4);
 
-void send_consumer_report_callback(struct k_work *work) {
-    struct zmk_hid_consumer_report_body report;
+static void send_consumer_report_callback(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(hog_consumer_work, send_consumer_report_callback);
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
+// The report last taken off the queue to be sent, which the host sees before the queued ones.
+static struct zmk_hid_consumer_report_body last_sent_consumer_report;
+
+static void consumer_report_sent(struct bt_conn *conn, void *user_data) {
+    k_work_reschedule_for_queue(&hog_work_q, &hog_consumer_work, K_NO_WAIT);
+}
+
+static void skip_superseded_consumer_reports(struct consumer_queued_report *report) {
+    struct consumer_queued_report next;
+    while (k_msgq_peek(&zmk_hog_consumer_msgq, &next) == 0 &&
+           zmk_hid_consumer_report_body_is_skippable(&last_sent_consumer_report, &report->body,
+                                                     &next.body)) {
+        k_msgq_get(&zmk_hog_consumer_msgq, &next, K_NO_WAIT);
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        if (report->probe_origin != 0) {
+            next.probe_origin = report->probe_origin;
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        *report = next;
+    }
+}
+
+// Takes the next report to send off the queue. The scheduler is locked meanwhile, so
+// queue_consumer_report_when_full() always finds the report either queued or recorded as sent.
+static int take_consumer_report(struct consumer_queued_report *report) {
+    k_sched_lock();
+
+    int err = k_msgq_get(&zmk_hog_consumer_msgq, report, K_NO_WAIT);
+    if (err == 0) {
+        skip_superseded_consumer_reports(report);
+        last_sent_consumer_report = report->body;
+    }
+
+    k_sched_unlock();
+    return err;
+}
+
+static struct consumer_queued_report
+    compacted_consumer_reports[CONFIG_ZMK_BLE_CONSUMER_REPORT_QUEUE_SIZE];
+
+// Leaves out the compacted reports that the next one supersedes and returns how many are left.
+static size_t compact_consumer_reports(size_t count, struct consumer_queued_report *next) {
+    while (count > 0) {
+        const struct zmk_hid_consumer_report_body *prev =
+            count > 1 ? &compacted_consumer_reports[count - 2].body : &last_sent_consumer_report;
+        const struct zmk_hid_consumer_report_body *pending =
+            &compacted_consumer_reports[count - 1].body;
+        if (!zmk_hid_consumer_report_body_is_skippable(prev, pending, &next->body)) {
+            break;
+        }
+
+        count--;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        if (compacted_consumer_reports[count].probe_origin != 0) {
+            next->probe_origin = compacted_consumer_reports[count].probe_origin;
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    }
+
+    return count;
+}
+
+// Makes room for a report in the full queue without dropping the older reports, which may hold a
+// press or release the host hasn't seen yet. Like when sending, reports that a later one
+// supersedes are left out. If none are, the newest state replaces the last queued report.
+static void queue_consumer_report_when_full(const struct consumer_queued_report *queued) {
+    struct consumer_queued_report next;
+    size_t count = 0;
 
-    while (k_msgq_get(&zmk_hog_consumer_msgq, &report, K_NO_WAIT) == 0) {
+    k_sched_lock();
+
+    while (k_msgq_get(&zmk_hog_consumer_msgq, &next, K_NO_WAIT) == 0) {
+        count = compact_consumer_reports(count, &next);
+        compacted_consumer_reports[count++] = next;
+    }
+
+    next = *queued;
+    count = compact_consumer_reports(count, &next);
+    if (count < ARRAY_SIZE(compacted_consumer_reports)) {
+        compacted_consumer_reports[count++] = next;
+    } else {
+        LOG_WRN("Consumer report queue full, merged the report into the last queued one");
+        compacted_consumer_reports[count - 1].body = next.body;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        k_msgq_put(&zmk_hog_consumer_msgq, &compacted_consumer_reports[i], K_NO_WAIT);
+    }
+
+    k_sched_unlock();
+}
+
+#else
+
+static int take_consumer_report(struct consumer_queued_report *report) {
+    return k_msgq_get(&zmk_hog_consumer_msgq, report, K_NO_WAIT);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
+static void send_consumer_report_callback(struct k_work *work) {
+    struct consumer_queued_report report;
+
+    while (take_consumer_report(&report) == 0) {
         struct bt_conn *conn = zmk_ble_active_profile_conn();
         if (conn == NULL) {
             return;
         }
 
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+        wait_for_report_sent(conn, &hog_consumer_work);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
         struct bt_gatt_notify_params notify_params = {
             .attr = &hog_svc.attrs[9],
-            .data = &report,
-            .len = sizeof(report),
+            .data = &report.body,
+            .len = sizeof(report.body),
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+            .func = consumer_report_sent,
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
         };
 
         int err = bt_gatt_notify_cb(conn, &notify_params);
@@ -361,22 +648,43 @@ void send_consumer_report_callback(struct k_work *work) {
         } else if (err) {
             LOG_DBG("Error notifying %d", err);
         }
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        else {
+            zmk_latency_probe_record(ZMK_TRANSPORT_BLE, report.probe_origin);
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
 
         bt_conn_unref(conn);
-    }
-};
 
-K_WORK_DEFINE(hog_consumer_work, send_consumer_report_callback);
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+        if (err == 0) {
+            return;
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+    }
+}
 
 int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_consumer_msgq, report, K_MSEC(100));
+    struct consumer_queued_report queued = {
+        .body = *report,
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        .probe_origin = zmk_latency_probe_get_origin(),
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    };
+
+    int err = k_msgq_put(&zmk_hog_consumer_msgq, &queued, K_MSEC(100));
     if (err) {
         switch (err) {
         case -EAGAIN: {
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+            queue_consumer_report_when_full(&queued);
+            break;
+#else
             LOG_WRN("Consumer message queue full, popping first message and queueing again");
-            struct zmk_hid_consumer_report_body discarded_report;
+            struct consumer_queued_report discarded_report;
             k_msgq_get(&zmk_hog_consumer_msgq, &discarded_report, K_NO_WAIT);
             return zmk_hog_send_consumer_report(report);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
         }
         default:
             LOG_WRN("Failed to queue consumer report to send (%d)", err);
@@ -384,7 +692,7 @@ int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *report) {
         }
     }
 
-    k_work_submit_to_queue(&hog_work_q, &hog_consumer_work);
+    k_work_schedule_for_queue(&hog_work_q, &hog_consumer_work, K_NO_WAIT);
 
     return 0;
 };
@@ -23,7 +23,11 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/layer_state_changed.h>
 #include <zmk/events/sensor_event.h>
 
-static zmk_keymap_layers_state_t _zmk_keymap_layer_state = 0;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+#include <zmk/latency_probe.h>
+#endif
+
+static zmk_keymap_layers_state_t _zmk_keymap_layer_state;
 static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
 
 #define DT_DRV_COMPAT zmk_keymap
@@ -64,7 +68,7 @@ static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
 // When a behavior handles a key position "down" event, we record the layer state
 // here so that even if that layer is deactivated before the "up", event, we
 // still send the release event to the behavior in that layer also.
-static uint32_t zmk_keymap_active_behavior_layer[ZMK_KEYMAP_LEN];
+static zmk_keymap_layers_state_t zmk_keymap_active_behavior_layer[ZMK_KEYMAP_LEN];
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
@@ -81,8 +85,18 @@ static uint8_t keymap_layer_orders[ZMK_KEYMAP_LAYERS_LEN];
                          (DT_INST_FOREACH_CHILD_STATUS_OKAY_SEP(0, TRANSFORMED_LAYER, (, ))))),    \
             (0))};
 
-KEYMAP_VAR(zmk_keymap, COND_CODE_1(IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE), (), (const)),
-           IS_ENABLED(CONFIG_ZMK_STUDIO))
+#if !IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS) &&                                             \
+    !IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+
+// The keymap needs to be writable if it can be edited, or if we resolve and store the behavior
+// devices in its bindings at startup.
+#define KEYMAP_WRITABLE                                                                            \
+    (IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE) ||                                             \
+     IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS))
+
+KEYMAP_VAR(zmk_keymap, COND_CODE_1(KEYMAP_WRITABLE, (), (const)), IS_ENABLED(CONFIG_ZMK_STUDIO))
+
+#endif // !IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS) && ...
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
@@ -91,7 +105,7 @@ KEYMAP_VAR(zmk_stock_keymap, const, 0)
 static char zmk_keymap_layer_names[ZMK_KEYMAP_LAYERS_LEN][CONFIG_ZMK_KEYMAP_LAYER_NAME_MAX_LEN] = {
     DT_INST_FOREACH_CHILD_SEP(0, LAYER_NAME, (, ))};
 
-static uint32_t changed_layer_names = 0;
+static zmk_keymap_layers_state_t changed_layer_names;
 
 #else
 
@@ -108,6 +122,312 @@ static struct zmk_behavior_binding
 
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
+static bool bindings_equal(const struct zmk_behavior_binding *a,
+                           const struct zmk_behavior_binding *b) {
+    if (a->param1 != b->param1 || a->param2 != b->param2) {
+        return false;
+    }
+
+    if (a->behavior_dev == b->behavior_dev) {
+        return true;
+    }
+
+    return a->behavior_dev && b->behavior_dev && strcmp(a->behavior_dev, b->behavior_dev) == 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
+// Compact bindings refer to behaviors by their index in the behavior local ID map, and store each
+// param in 15 bits when it fits, or as a reference to a shared pool of wider values otherwise.
+// Most params, e.g. layer numbers or mouse buttons, fit inline, while keycodes with their usage
+// page are repeated across layers, so deduplicating them in the pool keeps it small.
+
+#define PACKED_BEHAVIOR_NONE UINT8_MAX
+#define PACKED_PARAM_POOLED BIT(15)
+#define PARAM_POOL_SIZE CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS_PARAM_POOL_SIZE
+
+struct packed_binding {
+    uint8_t behavior;
+    uint16_t param1;
+    uint16_t param2;
+} __packed;
+
+static struct packed_binding zmk_keymap_packed[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN];
+
+static uint32_t keymap_param_pool[PARAM_POOL_SIZE];
+static uint8_t keymap_param_pool_used[DIV_ROUND_UP(PARAM_POOL_SIZE, 8)];
+
+// A zeroed entry would refer to the first behavior in the local ID map, so every entry starts out
+// empty, and bindings that fail to pack are left that way.
+static void clear_packed_keymap(void) {
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
+            zmk_keymap_packed[l][k] = (struct packed_binding){.behavior = PACKED_BEHAVIOR_NONE};
+        }
+    }
+}
+
+static uint8_t packed_behavior_index(const char *name) {
+    if (name == NULL || name[0] == '\0') {
+        return PACKED_BEHAVIOR_NONE;
+    }
+
+    uint8_t index = 0;
+    STRUCT_SECTION_FOREACH(zmk_behavior_local_id_map, item) {
+        if (index == PACKED_BEHAVIOR_NONE) {
+            break;
+        }
+
+        if (item->device->name == name || strcmp(item->device->name, name) == 0) {
+            return index;
+        }
+
+        index++;
+    }
+
+    return PACKED_BEHAVIOR_NONE;
+}
+
+static inline bool param_pool_slot_used(int slot) {
+    return (keymap_param_pool_used[slot / 8] & BIT(slot % 8)) != 0;
+}
+
+static inline void mark_param_pool_slot(uint16_t packed) {
+    if (packed & PACKED_PARAM_POOLED) {
+        uint16_t slot = packed & ~PACKED_PARAM_POOLED;
+        WRITE_BIT(keymap_param_pool_used[slot / 8], slot % 8, 1);
+    }
+}
+
+// Free any pool slots that are no longer referenced from the keymap, except for @p keep, which
+// may be a param of a binding that hasn't been stored yet.
+static void collect_param_pool(uint16_t keep) {
+    memset(keymap_param_pool_used, 0, sizeof(keymap_param_pool_used));
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
+            mark_param_pool_slot(zmk_keymap_packed[l][k].param1);
+            mark_param_pool_slot(zmk_keymap_packed[l][k].param2);
+        }
+    }
+
+    mark_param_pool_slot(keep);
+}
+
+static int pack_param(uint32_t value, uint16_t keep, uint16_t *packed) {
+    if (value < PACKED_PARAM_POOLED) {
+        *packed = value;
+        return 0;
+    }
+
+    int free_slot = -1;
+    for (int i = 0; i < PARAM_POOL_SIZE; i++) {
+        if (!param_pool_slot_used(i)) {
+            if (free_slot < 0) {
+                free_slot = i;
+            }
+            continue;
+        }
+
+        if (keymap_param_pool[i] == value) {
+            *packed = PACKED_PARAM_POOLED | i;
+            return 0;
+        }
+    }
+
+    if (free_slot < 0) {
+        collect_param_pool(keep);
+
+        for (int i = 0; i < PARAM_POOL_SIZE; i++) {
+            if (!param_pool_slot_used(i)) {
+                free_slot = i;
+                break;
+            }
+        }
+
+        if (free_slot < 0) {
+            LOG_ERR("No room left in the keymap param pool for 0x%08X", value);
+            return -ENOMEM;
+        }
+    }
+
+    keymap_param_pool[free_slot] = value;
+    WRITE_BIT(keymap_param_pool_used[free_slot / 8], free_slot % 8, 1);
+    *packed = PACKED_PARAM_POOLED | free_slot;
+
+    return 0;
+}
+
+static inline uint32_t unpack_param(uint16_t packed) {
+    return (packed & PACKED_PARAM_POOLED) ? keymap_param_pool[packed & ~PACKED_PARAM_POOLED]
+                                          : packed;
+}
+
+static void keymap_read_binding(zmk_keymap_layer_id_t layer_id, uint32_t position,
+                                struct zmk_behavior_binding *binding) {
+    const struct packed_binding *packed = &zmk_keymap_packed[layer_id][position];
+
+    *binding = (struct zmk_behavior_binding){
+        .param1 = unpack_param(packed->param1),
+        .param2 = unpack_param(packed->param2),
+    };
+
+    if (packed->behavior == PACKED_BEHAVIOR_NONE) {
+        return;
+    }
+
+    struct zmk_behavior_local_id_map *item;
+    STRUCT_SECTION_GET(zmk_behavior_local_id_map, packed->behavior, &item);
+
+    binding->behavior_dev = item->device->name;
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+    binding->local_id = item->local_id;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+    binding->dev = device_is_ready(item->device) ? item->device : NULL;
+#endif
+}
+
+static int keymap_write_binding(zmk_keymap_layer_id_t layer_id, uint32_t position,
+                                const struct zmk_behavior_binding *binding) {
+    struct packed_binding packed = {.behavior = packed_behavior_index(binding->behavior_dev)};
+
+    if (packed.behavior == PACKED_BEHAVIOR_NONE && binding->behavior_dev &&
+        binding->behavior_dev[0] != '\0') {
+        LOG_WRN("Can't store binding for unknown behavior %s", binding->behavior_dev);
+        return -ENODEV;
+    }
+
+    int err = pack_param(binding->param1, 0, &packed.param1);
+    if (err < 0) {
+        return err;
+    }
+
+    err = pack_param(binding->param2, packed.param1, &packed.param2);
+    if (err < 0) {
+        return err;
+    }
+
+    zmk_keymap_packed[layer_id][position] = packed;
+
+    return 0;
+}
+
+#elif IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+
+// The stock keymap stays in flash, and only bindings that differ from it are stored in RAM. A
+// bitmap of the overridden positions on each layer keeps lookups of unedited keys to a bit test.
+
+#define OVERLAY_POSITIONS_WORDS DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)
+
+struct keymap_overlay_entry {
+    zmk_keymap_layer_id_t layer_id;
+    uint16_t position;
+    struct zmk_behavior_binding binding;
+};
+
+static struct keymap_overlay_entry keymap_overlay[CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS_MAX];
+static size_t keymap_overlay_len = 0;
+
+static uint32_t keymap_overlay_positions[ZMK_KEYMAP_LAYERS_LEN][OVERLAY_POSITIONS_WORDS];
+
+static struct keymap_overlay_entry *find_overlay_entry(zmk_keymap_layer_id_t layer_id,
+                                                       uint32_t position) {
+    if (!(keymap_overlay_positions[layer_id][position / 32] & BIT(position % 32))) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < keymap_overlay_len; i++) {
+        if (keymap_overlay[i].layer_id == layer_id && keymap_overlay[i].position == position) {
+            return &keymap_overlay[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void remove_overlay_entry(struct keymap_overlay_entry *entry) {
+    WRITE_BIT(keymap_overlay_positions[entry->layer_id][entry->position / 32],
+              entry->position % 32, 0);
+
+    *entry = keymap_overlay[--keymap_overlay_len];
+}
+
+static void clear_overlay(void) {
+    keymap_overlay_len = 0;
+    memset(keymap_overlay_positions, 0, sizeof(keymap_overlay_positions));
+}
+
+static inline const struct zmk_behavior_binding *keymap_binding(zmk_keymap_layer_id_t layer_id,
+                                                                uint32_t position) {
+    const struct keymap_overlay_entry *entry = find_overlay_entry(layer_id, position);
+
+    return entry ? &entry->binding : &zmk_stock_keymap[layer_id][position];
+}
+
+static inline void keymap_read_binding(zmk_keymap_layer_id_t layer_id, uint32_t position,
+                                       struct zmk_behavior_binding *binding) {
+    *binding = *keymap_binding(layer_id, position);
+}
+
+static int keymap_write_binding(zmk_keymap_layer_id_t layer_id, uint32_t position,
+                                const struct zmk_behavior_binding *binding) {
+    struct keymap_overlay_entry *entry = find_overlay_entry(layer_id, position);
+
+    if (bindings_equal(binding, &zmk_stock_keymap[layer_id][position])) {
+        if (entry) {
+            remove_overlay_entry(entry);
+        }
+
+        return 0;
+    }
+
+    if (!entry) {
+        if (keymap_overlay_len >= ARRAY_SIZE(keymap_overlay)) {
+            LOG_ERR("No room left to store the binding at %d on layer %d", position, layer_id);
+            return -ENOMEM;
+        }
+
+        entry = &keymap_overlay[keymap_overlay_len++];
+        entry->layer_id = layer_id;
+        entry->position = position;
+        WRITE_BIT(keymap_overlay_positions[layer_id][position / 32], position % 32, 1);
+    }
+
+    entry->binding = *binding;
+
+    return zmk_behavior_resolve_binding_device(&entry->binding);
+}
+
+#else
+
+static inline const struct zmk_behavior_binding *keymap_binding(zmk_keymap_layer_id_t layer_id,
+                                                                uint32_t position) {
+    return &zmk_keymap[layer_id][position];
+}
+
+static inline void keymap_read_binding(zmk_keymap_layer_id_t layer_id, uint32_t position,
+                                       struct zmk_behavior_binding *binding) {
+    *binding = zmk_keymap[layer_id][position];
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
+static int keymap_write_binding(zmk_keymap_layer_id_t layer_id, uint32_t position,
+                                const struct zmk_behavior_binding *binding) {
+    zmk_keymap[layer_id][position] = *binding;
+
+    return zmk_behavior_resolve_binding_device(&zmk_keymap[layer_id][position]);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
 #define ASSERT_LAYER_VAL(_layer, _fail_ret)                                                        \
     if ((_layer) >= ZMK_KEYMAP_LAYERS_LEN) {                                                       \
         return (_fail_ret);                                                                        \
@@ -135,6 +455,115 @@ uint8_t map_layer_id_to_index(zmk_keymap_layer_id_t layer_id) {
 
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_RESOLVED_BINDINGS_CACHE)
+
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_transparent)
+#define TRANSPARENT_BEHAVIOR DEVICE_DT_GET(DT_INST(0, zmk_behavior_transparent))
+#else
+#define TRANSPARENT_BEHAVIOR NULL
+#endif
+
+#define OPAQUE_POSITIONS_WORDS DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)
+
+// For each layer ID, the key positions with a binding that isn't always transparent, i.e. one that
+// references a behavior other than &trans.
+static uint32_t keymap_opaque_positions[ZMK_KEYMAP_LAYERS_LEN][OPAQUE_POSITIONS_WORDS];
+
+// For each key position, the index of the highest layer in the current layer state with an opaque
+// binding at that position, or ZMK_KEYMAP_LAYER_ID_INVAL if there is none.
+static zmk_keymap_layer_index_t keymap_resolved_layers[ZMK_KEYMAP_LEN];
+
+static bool keymap_resolved_layers_valid = false;
+
+static inline bool position_is_opaque(zmk_keymap_layer_id_t layer_id, uint32_t position) {
+    return (keymap_opaque_positions[layer_id][position / 32] & BIT(position % 32)) != 0;
+}
+
+static zmk_keymap_layer_index_t resolve_position_layer(uint32_t position, int from_idx,
+                                                       int default_idx,
+                                                       zmk_keymap_layers_state_t state) {
+    for (int layer_idx = from_idx; layer_idx >= default_idx; layer_idx--) {
+        zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
+
+        if (layer_id == ZMK_KEYMAP_LAYER_ID_INVAL) {
+            continue;
+        }
+        if (zmk_keymap_layer_active_with_state(layer_id, state) &&
+            position_is_opaque(layer_id, position)) {
+            return layer_idx;
+        }
+    }
+
+    return ZMK_KEYMAP_LAYER_ID_INVAL;
+}
+
+static void rebuild_resolved_layers(void) {
+    const struct device *transparent = TRANSPARENT_BEHAVIOR;
+
+    // Key positions are those of the selected physical layout, while the bindings are stored by
+    // their position in the stock layout, same as in zmk_keymap_apply_position_state().
+    const uint32_t *pos_map;
+    int pos_map_len = zmk_physical_layouts_get_selected_to_stock_position_map(&pos_map);
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
+            bool opaque = false;
+
+            if (k < pos_map_len && pos_map[k] < ZMK_KEYMAP_LEN) {
+                struct zmk_behavior_binding binding;
+                keymap_read_binding(l, pos_map[k], &binding);
+
+                const struct device *behavior = zmk_behavior_get_binding_device(&binding);
+                opaque = behavior != NULL && behavior != transparent;
+            }
+
+            WRITE_BIT(keymap_opaque_positions[l][k / 32], k % 32, opaque);
+        }
+    }
+
+    int default_idx = LAYER_ID_TO_INDEX(_zmk_keymap_layer_default);
+    for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
+        keymap_resolved_layers[k] = resolve_position_layer(k, ZMK_KEYMAP_LAYERS_LEN - 1,
+                                                           default_idx, _zmk_keymap_layer_state);
+    }
+
+    keymap_resolved_layers_valid = true;
+}
+
+static inline void invalidate_resolved_layers(void) { keymap_resolved_layers_valid = false; }
+
+static void update_resolved_layers(zmk_keymap_layer_id_t layer_id, bool state) {
+    if (!keymap_resolved_layers_valid) {
+        return;
+    }
+
+    int default_idx = LAYER_ID_TO_INDEX(_zmk_keymap_layer_default);
+    int layer_idx = LAYER_ID_TO_INDEX(layer_id);
+    if (layer_idx == ZMK_KEYMAP_LAYER_ID_INVAL || layer_idx < default_idx) {
+        return;
+    }
+
+    for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
+        zmk_keymap_layer_index_t resolved = keymap_resolved_layers[k];
+
+        if (state) {
+            if (position_is_opaque(layer_id, k) &&
+                (resolved == ZMK_KEYMAP_LAYER_ID_INVAL || layer_idx > resolved)) {
+                keymap_resolved_layers[k] = layer_idx;
+            }
+        } else if (resolved == layer_idx) {
+            keymap_resolved_layers[k] =
+                resolve_position_layer(k, layer_idx - 1, default_idx, _zmk_keymap_layer_state);
+        }
+    }
+}
+
+#else
+
+static inline void invalidate_resolved_layers(void) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_RESOLVED_BINDINGS_CACHE)
+
 static inline int set_layer_state(zmk_keymap_layer_id_t layer_id, bool state) {
     int ret = 0;
     if (layer_id >= ZMK_KEYMAP_LAYERS_LEN) {
@@ -147,9 +576,12 @@ static inline int set_layer_state(zmk_keymap_layer_id_t layer_id, bool state) {
     }
 
     zmk_keymap_layers_state_t old_state = _zmk_keymap_layer_state;
-    WRITE_BIT(_zmk_keymap_layer_state, layer_id, state);
+    zmk_keymap_layers_state_write(&_zmk_keymap_layer_state, layer_id, state);
     // Don't send state changes unless there was an actual change
-    if (old_state != _zmk_keymap_layer_state) {
+    if (!zmk_keymap_layers_state_equal(old_state, _zmk_keymap_layer_state)) {
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_RESOLVED_BINDINGS_CACHE)
+        update_resolved_layers(layer_id, state);
+#endif
         LOG_DBG("layer_changed: layer %d state %d", layer_id, state);
         ret = raise_layer_state_changed(layer_id, state);
         if (ret < 0) {
@@ -174,7 +606,7 @@ bool zmk_keymap_layer_active_with_state(zmk_keymap_layer_id_t layer,
                                         zmk_keymap_layers_state_t state_to_test) {
     // The default layer is assumed to be ALWAYS ACTIVE so we include an || here to ensure nobody
     // breaks up that assumption by accident
-    return (state_to_test & (BIT(layer))) == (BIT(layer)) || layer == _zmk_keymap_layer_default;
+    return zmk_keymap_layers_state_test(state_to_test, layer) || layer == _zmk_keymap_layer_default;
 };
 
 bool zmk_keymap_layer_active(zmk_keymap_layer_id_t layer) {
@@ -182,6 +614,11 @@ bool zmk_keymap_layer_active(zmk_keymap_layer_id_t layer) {
 };
 
 zmk_keymap_layer_index_t zmk_keymap_highest_layer_active(void) {
+#if !IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+    // Without reordering, layer indexes and IDs are the same, so the highest set bit is the answer
+    return MAX(zmk_keymap_layers_state_highest(_zmk_keymap_layer_state),
+               (int)_zmk_keymap_layer_default);
+#else
     for (int layer_idx = ZMK_KEYMAP_LAYERS_LEN - 1;
          layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default); layer_idx--) {
         zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
@@ -195,6 +632,7 @@ zmk_keymap_layer_index_t zmk_keymap_highest_layer_active(void) {
     }
 
     return LAYER_ID_TO_INDEX(zmk_keymap_layer_default());
+#endif
 }
 
 int zmk_keymap_layer_activate(zmk_keymap_layer_id_t layer) { return set_layer_state(layer, true); };
@@ -227,34 +665,61 @@ const char *zmk_keymap_layer_name(zmk_keymap_layer_id_t layer_id) {
     return zmk_keymap_layer_names[layer_id];
 }
 
-const struct zmk_behavior_binding *
-zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t binding_idx) {
+static int map_binding_idx(uint8_t binding_idx) {
     if (binding_idx >= ZMK_KEYMAP_LEN) {
-        return NULL;
+        return -EINVAL;
     }
 
-    ASSERT_LAYER_VAL(layer_id, NULL)
-
     const uint32_t *pos_map;
     int ret = zmk_physical_layouts_get_selected_to_stock_position_map(&pos_map);
     if (ret < 0) {
         LOG_WRN("Failed to get the position map, can't find the right binding to return (%d)", ret);
-        return NULL;
+        return ret;
     }
 
     if (binding_idx >= ret) {
         LOG_WRN("Can't return binding for unmapped binding index %d", binding_idx);
-        return NULL;
+        return -EINVAL;
     }
 
     uint32_t mapped_idx = pos_map[binding_idx];
 
     if (mapped_idx >= ZMK_KEYMAP_LEN) {
         LOG_WRN("Binding index %d mapped to an invalid key position %d", binding_idx, mapped_idx);
+        return -EINVAL;
+    }
+
+    return mapped_idx;
+}
+
+#if !IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
+const struct zmk_behavior_binding *
+zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t binding_idx) {
+    ASSERT_LAYER_VAL(layer_id, NULL)
+
+    int mapped_idx = map_binding_idx(binding_idx);
+    if (mapped_idx < 0) {
         return NULL;
     }
 
-    return &zmk_keymap[layer_id][mapped_idx];
+    return keymap_binding(layer_id, mapped_idx);
+}
+
+#endif // !IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
+int zmk_keymap_read_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t binding_idx,
+                                         struct zmk_behavior_binding *binding) {
+    ASSERT_LAYER_VAL(layer_id, -EINVAL)
+
+    int mapped_idx = map_binding_idx(binding_idx);
+    if (mapped_idx < 0) {
+        return mapped_idx;
+    }
+
+    keymap_read_binding(layer_id, mapped_idx, binding);
+
+    return 0;
 }
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
@@ -290,18 +755,31 @@ int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t
         return -EINVAL;
     }
 
-    if (memcmp(&zmk_keymap[layer_id][storage_binding_idx], &binding, sizeof(binding)) == 0) {
+    struct zmk_behavior_binding current;
+    keymap_read_binding(layer_id, storage_binding_idx, &current);
+
+    if (bindings_equal(&current, &binding)) {
         LOG_DBG("Not setting, no change to layer %d at index %d (%d)", layer_id, binding_idx,
                 storage_binding_idx);
         return 0;
     }
 
+    // TODO: Need a mutex to protect access to the keymap data?
+    int err = keymap_write_binding(layer_id, storage_binding_idx, &binding);
+    if (err < 0) {
+        LOG_WRN("Failed to store the new binding for %s (%d)", binding.behavior_dev, err);
+
+        // Full bindings are still stored when only resolving their behavior device fails
+        if (IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS) || err != -ENODEV) {
+            return err;
+        }
+    }
+
     uint8_t *pending = zmk_keymap_layer_pending_changes[layer_id];
 
     WRITE_BIT(pending[storage_binding_idx / 8], storage_binding_idx % 8, 1);
 
-    // TODO: Need a mutex to protect access to the keymap data?
-    memcpy(&zmk_keymap[layer_id][storage_binding_idx], &binding, sizeof(binding));
+    invalidate_resolved_layers();
 
     return 0;
 }
@@ -346,24 +824,27 @@ int zmk_keymap_move_layer(zmk_keymap_layer_index_t start_idx, zmk_keymap_layer_i
         keymap_layer_orders[dest_idx] = val;
     }
 
+    invalidate_resolved_layers();
+
     return 0;
 }
 
 int zmk_keymap_add_layer(void) {
-    uint32_t seen_layer_ids = 0;
+    zmk_keymap_layers_state_t seen_layer_ids = {0};
     LOG_HEXDUMP_DBG(keymap_layer_orders, ZMK_KEYMAP_LAYERS_LEN, "Order");
 
     for (int index = 0; index < ZMK_KEYMAP_LAYERS_LEN; index++) {
         zmk_keymap_layer_id_t id = LAYER_INDEX_TO_ID(index);
 
         if (id != ZMK_KEYMAP_LAYER_ID_INVAL) {
-            WRITE_BIT(seen_layer_ids, id, 1);
+            zmk_keymap_layers_state_write(&seen_layer_ids, id, true);
             continue;
         }
 
         for (int candidate_id = 0; candidate_id < ZMK_KEYMAP_LAYERS_LEN; candidate_id++) {
-            if (!(seen_layer_ids & BIT(candidate_id))) {
+            if (!zmk_keymap_layers_state_test(seen_layer_ids, candidate_id)) {
                 keymap_layer_orders[index] = candidate_id;
+                invalidate_resolved_layers();
                 return index;
             }
         }
@@ -388,6 +869,7 @@ int zmk_keymap_remove_layer(zmk_keymap_layer_index_t index) {
     }
 
     keymap_layer_orders[ZMK_KEYMAP_LAYERS_LEN - 1] = ZMK_KEYMAP_LAYER_ID_INVAL;
+    invalidate_resolved_layers();
 
     LOG_HEXDUMP_DBG(keymap_layer_orders, ZMK_KEYMAP_LAYERS_LEN, "Order");
 
@@ -403,6 +885,7 @@ int zmk_keymap_restore_layer(zmk_keymap_layer_id_t id, zmk_keymap_layer_index_t
     }
 
     keymap_layer_orders[at_index] = id;
+    invalidate_resolved_layers();
 
     return 0;
 }
@@ -421,7 +904,7 @@ int zmk_keymap_set_layer_name(zmk_keymap_layer_id_t id, const char *name, size_t
         zmk_keymap_layer_names[id][size] = 0;
     }
 
-    WRITE_BIT(changed_layer_names, id, 1);
+    zmk_keymap_layers_state_write(&changed_layer_names, id, true);
 
     return 0;
 }
@@ -458,6 +941,36 @@ struct zmk_behavior_binding_setting {
     uint32_t param2;
 } __packed;
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+
+// Each layer blob holds the bindings of the layer that differ from the stock keymap, so that
+// saving a layer is a single settings write however many of its bindings changed.
+
+#define LAYER_BLOB_VERSION 1
+
+struct zmk_keymap_layer_blob_entry {
+    uint16_t position;
+    struct zmk_behavior_binding_setting binding;
+} __packed;
+
+struct zmk_keymap_layer_blob {
+    uint8_t version;
+    struct zmk_keymap_layer_blob_entry entries[ZMK_KEYMAP_LEN];
+} __packed;
+
+#define LAYER_BLOB_HEADER_SIZE offsetof(struct zmk_keymap_layer_blob, entries)
+
+// Shared by saving and loading, which never run at the same time
+static struct zmk_keymap_layer_blob layer_blob;
+
+static zmk_keymap_layers_state_t blob_loaded_layers;
+
+// Positions saved with the older per binding keys, to be deleted once their layer is saved as a
+// blob.
+static uint8_t legacy_binding_positions[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+
 int zmk_keymap_check_unsaved_changes(void) {
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
         uint8_t *pending = zmk_keymap_layer_pending_changes[l];
@@ -480,6 +993,88 @@ int zmk_keymap_check_unsaved_changes(void) {
 #define LAYER_ORDER_SETTINGS_KEY "keymap/layer_order"
 #define LAYER_NAME_SETTINGS_KEY "keymap/l_n/%d"
 #define LAYER_BINDING_SETTINGS_KEY "keymap/l/%d/%d"
+#define LAYER_BLOB_SETTINGS_KEY "keymap/lb/%d"
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+
+static int save_layer_blob(zmk_keymap_layer_id_t layer_id) {
+    size_t count = 0;
+
+    layer_blob.version = LAYER_BLOB_VERSION;
+
+    for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+        struct zmk_behavior_binding binding;
+        keymap_read_binding(layer_id, kp, &binding);
+
+        if (bindings_equal(&binding, &zmk_stock_keymap[layer_id][kp])) {
+            continue;
+        }
+
+        layer_blob.entries[count++] = (struct zmk_keymap_layer_blob_entry){
+            .position = kp,
+            .binding =
+                {
+                    .behavior_local_id = zmk_behavior_get_local_id(binding.behavior_dev),
+                    .param1 = binding.param1,
+                    .param2 = binding.param2,
+                },
+        };
+    }
+
+    LOG_DBG("Saving %d changed bindings for layer %d", count, layer_id);
+
+    char setting_name[14];
+    sprintf(setting_name, LAYER_BLOB_SETTINGS_KEY, layer_id);
+
+    int ret;
+    if (count == 0) {
+        ret = settings_delete(setting_name);
+    } else {
+        ret = settings_save_one(setting_name, &layer_blob,
+                                LAYER_BLOB_HEADER_SIZE +
+                                    count * sizeof(struct zmk_keymap_layer_blob_entry));
+    }
+
+    if (ret < 0) {
+        LOG_ERR("Failed to save keymap bindings for layer %d (%d)", layer_id, ret);
+        return ret;
+    }
+
+    uint8_t *legacy = legacy_binding_positions[layer_id];
+    for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+        if (legacy[kp / 8] & BIT(kp % 8)) {
+            char binding_setting_name[20];
+            sprintf(binding_setting_name, LAYER_BINDING_SETTINGS_KEY, layer_id, kp);
+            settings_delete(binding_setting_name);
+        }
+    }
+
+    memset(legacy, 0, PENDING_ARRAY_SIZE);
+    memset(zmk_keymap_layer_pending_changes[layer_id], 0, PENDING_ARRAY_SIZE);
+
+    return 0;
+}
+
+static int save_bindings(void) {
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        uint8_t *pending = zmk_keymap_layer_pending_changes[l];
+
+        for (int i = 0; i < PENDING_ARRAY_SIZE; i++) {
+            if (pending[i]) {
+                int ret = save_layer_blob(l);
+                if (ret < 0) {
+                    return ret;
+                }
+
+                break;
+            }
+        }
+    }
+
+    return 0;
+}
+
+#else
 
 static int save_bindings(void) {
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
@@ -488,14 +1083,15 @@ static int save_bindings(void) {
         for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
             if (pending[kp / 8] & BIT(kp % 8)) {
 
-                const struct zmk_behavior_binding *binding = &zmk_keymap[l][kp];
+                struct zmk_behavior_binding binding;
+                keymap_read_binding(l, kp, &binding);
                 LOG_DBG("Pending save for layer %d at key position %d: %s with %d, %d", l, kp,
-                        binding->behavior_dev, binding->param1, binding->param2);
+                        binding.behavior_dev, binding.param1, binding.param2);
 
                 struct zmk_behavior_binding_setting binding_setting = {
-                    .behavior_local_id = zmk_behavior_get_local_id(binding->behavior_dev),
-                    .param1 = binding->param1,
-                    .param2 = binding->param2,
+                    .behavior_local_id = zmk_behavior_get_local_id(binding.behavior_dev),
+                    .param1 = binding.param1,
+                    .param2 = binding.param2,
                 };
 
                 // We can skip any trailing zero params, regardless of the behavior
@@ -526,6 +1122,8 @@ static int save_bindings(void) {
     return 0;
 }
 
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 static int save_layer_orders(void) {
     int ret = settings_save_one(LAYER_ORDER_SETTINGS_KEY, keymap_layer_orders,
@@ -541,7 +1139,7 @@ static int save_layer_orders(void) {
 
 static int save_layer_names(void) {
     for (int id = 0; id < ZMK_KEYMAP_LAYERS_LEN; id++) {
-        if (changed_layer_names & BIT(id)) {
+        if (zmk_keymap_layers_state_test(changed_layer_names, id)) {
             char setting_name[14];
             sprintf(setting_name, LAYER_NAME_SETTINGS_KEY, id);
             int ret = settings_save_one(setting_name, zmk_keymap_layer_names[id],
@@ -552,7 +1150,7 @@ static int save_layer_names(void) {
         }
     }
 
-    changed_layer_names = 0;
+    changed_layer_names = (zmk_keymap_layers_state_t){0};
     return 0;
 }
 
@@ -586,15 +1184,33 @@ static void load_stock_keymap_layer_ordering() {
         keymap_layer_orders[i] = ZMK_KEYMAP_LAYER_ID_INVAL;
         i++;
     }
+
+    invalidate_resolved_layers();
 }
 #endif
 
 static void reload_from_stock_keymap(void) {
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+    blob_loaded_layers = (zmk_keymap_layers_state_t){0};
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+    clear_overlay();
+#else
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+    clear_packed_keymap();
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
         for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
-            zmk_keymap[l][k] = zmk_stock_keymap[l][k];
+            int err = keymap_write_binding(l, k, &zmk_stock_keymap[l][k]);
+            if (err < 0) {
+                LOG_WRN("Failed to load stock binding at %d on layer %d (%d)", k, l, err);
+            }
         }
     }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+
+    invalidate_resolved_layers();
 }
 
 int zmk_keymap_discard_changes(void) {
@@ -603,7 +1219,7 @@ int zmk_keymap_discard_changes(void) {
 
     int ret = settings_load_subtree("keymap");
     if (ret >= 0) {
-        changed_layer_names = 0;
+        changed_layer_names = (zmk_keymap_layers_state_t){0};
 
         for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
             memset(zmk_keymap_layer_pending_changes[l], 0, PENDING_ARRAY_SIZE);
@@ -651,11 +1267,19 @@ int zmk_keymap_reset_settings(void) {
         sprintf(layer_name_setting_name, LAYER_NAME_SETTINGS_KEY, l);
         settings_delete(layer_name_setting_name);
 
+        char layer_blob_setting_name[14];
+        sprintf(layer_blob_setting_name, LAYER_BLOB_SETTINGS_KEY, l);
+        settings_delete(layer_blob_setting_name);
+
         uint8_t *changes = zmk_keymap_layer_changes[l];
 
         for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
-            if (memcmp(&zmk_keymap[l][k], &zmk_stock_keymap[l][k],
-                       sizeof(struct zmk_behavior_binding_setting)) == 0) {
+            struct zmk_behavior_binding binding;
+            keymap_read_binding(l, k, &binding);
+
+            // Per binding keys may be shadowed by a layer blob, so delete them regardless
+            if (!IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS) &&
+                bindings_equal(&binding, &zmk_stock_keymap[l][k])) {
                 continue;
             }
 
@@ -668,6 +1292,10 @@ int zmk_keymap_reset_settings(void) {
         }
     }
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+    memset(legacy_binding_positions, 0, sizeof(legacy_binding_positions));
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+
     load_stock_keymap_layer_ordering();
 
     reload_from_stock_keymap();
@@ -687,8 +1315,12 @@ int zmk_keymap_reset_settings(void) { return -ENOTSUP; }
 
 int zmk_keymap_apply_position_state(uint8_t source, zmk_keymap_layer_id_t layer_id,
                                     uint32_t position, bool pressed, int64_t timestamp) {
-    const struct zmk_behavior_binding *binding =
-        zmk_keymap_get_layer_binding_at_idx(layer_id, position);
+    struct zmk_behavior_binding binding;
+    int err = zmk_keymap_read_layer_binding_at_idx(layer_id, position, &binding);
+    if (err < 0) {
+        return err;
+    }
+
     struct zmk_behavior_binding_event event = {
         .layer = layer_id,
         .position = position,
@@ -699,9 +1331,9 @@ int zmk_keymap_apply_position_state(uint8_t source, zmk_keymap_layer_id_t layer_
     };
 
     LOG_DBG("layer_id: %d position: %d, binding name: %s", layer_id, position,
-            binding->behavior_dev);
+            binding.behavior_dev);
 
-    return zmk_behavior_invoke_binding(binding, event, pressed);
+    return zmk_behavior_invoke_binding(&binding, event, pressed);
 }
 
 int zmk_keymap_position_state_changed(uint8_t source, uint32_t position, bool pressed,
@@ -711,8 +1343,27 @@ int zmk_keymap_position_state_changed(uint8_t source, uint32_t position, bool pr
     }
 
     // We use int here to be sure we don't loop layer_idx back to UINT8_MAX
-    for (int layer_idx = ZMK_KEYMAP_LAYERS_LEN - 1;
-         layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default); layer_idx--) {
+    int start_idx = ZMK_KEYMAP_LAYERS_LEN - 1;
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_RESOLVED_BINDINGS_CACHE)
+    // The cache only covers the current layer state, which a release may not have been pressed in.
+    // Transparent bindings are skipped, but we still walk down from the resolved layer in case its
+    // behavior asks for processing to continue.
+    if (zmk_keymap_layers_state_equal(zmk_keymap_active_behavior_layer[position],
+                                      _zmk_keymap_layer_state)) {
+        if (!keymap_resolved_layers_valid) {
+            rebuild_resolved_layers();
+        }
+
+        start_idx = keymap_resolved_layers[position];
+        if (start_idx == ZMK_KEYMAP_LAYER_ID_INVAL) {
+            return -ENOTSUP;
+        }
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_RESOLVED_BINDINGS_CACHE)
+
+    for (int layer_idx = start_idx; layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default);
+         layer_idx--) {
         zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
 
         if (layer_id == ZMK_KEYMAP_LAYER_ID_INVAL) {
@@ -755,7 +1406,7 @@ int zmk_keymap_sensor_event(uint8_t sensor_index,
         LOG_DBG("layer idx: %d, layer id: %d sensor_index: %d, binding name: %s", layer_idx,
                 layer_id, sensor_index, binding->behavior_dev);
 
-        const struct device *behavior = zmk_behavior_get_binding(binding->behavior_dev);
+        const struct device *behavior = zmk_behavior_get_binding_device(binding);
         if (!behavior) {
             LOG_DBG("No behavior assigned to %d on layer %d", sensor_index, layer_id);
             continue;
@@ -803,10 +1454,26 @@ int zmk_keymap_sensor_event(uint8_t sensor_index,
 int keymap_listener(const zmk_event_t *eh) {
     const struct zmk_position_state_changed *pos_ev;
     if ((pos_ev = as_zmk_position_state_changed(eh)) != NULL) {
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        uint32_t previous_origin = zmk_latency_probe_set_origin(pos_ev->probe_origin);
+        int ret = zmk_keymap_position_state_changed(pos_ev->source, pos_ev->position,
+                                                    pos_ev->state, pos_ev->timestamp);
+        zmk_latency_probe_set_origin(previous_origin);
+        return ret;
+#else
         return zmk_keymap_position_state_changed(pos_ev->source, pos_ev->position, pos_ev->state,
                                                  pos_ev->timestamp);
+#endif
     }
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_RESOLVED_BINDINGS_CACHE)
+    // The selected layout decides which stored binding each key position maps to.
+    if (as_zmk_physical_layout_selection_changed(eh) != NULL) {
+        invalidate_resolved_layers();
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_RESOLVED_BINDINGS_CACHE)
+
 #if ZMK_KEYMAP_HAS_SENSORS
     const struct zmk_sensor_event *sensor_ev;
     if ((sensor_ev = as_zmk_sensor_event(eh)) != NULL) {
@@ -821,12 +1488,178 @@ int keymap_listener(const zmk_event_t *eh) {
 ZMK_LISTENER(keymap, keymap_listener);
 ZMK_SUBSCRIPTION(keymap, zmk_position_state_changed);
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_RESOLVED_BINDINGS_CACHE)
+ZMK_SUBSCRIPTION(keymap, zmk_physical_layout_selection_changed);
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_RESOLVED_BINDINGS_CACHE)
+
 #if ZMK_KEYMAP_HAS_SENSORS
 ZMK_SUBSCRIPTION(keymap, zmk_sensor_event);
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
+static bool keymap_unresolved_bindings = false;
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
+static int apply_binding_setting(zmk_keymap_layer_id_t layer, uint32_t key_position,
+                                 const struct zmk_behavior_binding_setting *binding_setting) {
+    if (key_position >= ZMK_KEYMAP_LEN) {
+        LOG_WRN("Key position %d is larger than max of %d", key_position, ZMK_KEYMAP_LEN);
+        return -EINVAL;
+    }
+
+    const char *name =
+        zmk_behavior_find_behavior_name_from_local_id(binding_setting->behavior_local_id);
+
+    if (!name) {
+        LOG_WRN("Loaded device %d from settings but no device found by that local ID",
+                binding_setting->behavior_local_id);
+    }
+
+    struct zmk_behavior_binding binding = {
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+        .local_id = binding_setting->behavior_local_id,
+#endif
+        .behavior_dev = name,
+        .param1 = binding_setting->param1,
+        .param2 = binding_setting->param2,
+    };
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+    // Compact bindings can't hold on to an unresolved local ID, and the behavior local IDs may be
+    // loaded after the keymap, so retry once all settings are loaded.
+    if (!name) {
+        keymap_unresolved_bindings = true;
+        return 0;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
+    int err = keymap_write_binding(layer, key_position, &binding);
+    if (err == -ENOMEM) {
+        LOG_ERR("Failed to store keymap binding from settings (err %d)", err);
+        return err;
+    }
+
+    invalidate_resolved_layers();
+
+    return 0;
+}
+
+static int load_binding_setting(const char *next, size_t len, settings_read_cb read_cb,
+                                void *cb_arg) {
+    char *endptr;
+    uint8_t layer = strtoul(next, &endptr, 10);
+    if (*endptr != '/') {
+        LOG_WRN("Invalid layer number: %s with endptr %s", next, endptr);
+        return -EINVAL;
+    }
+
+    uint8_t key_position = strtoul(endptr + 1, &endptr, 10);
+
+    if (*endptr != '\0') {
+        LOG_WRN("Invalid key_position number: %s with endptr %s", next, endptr);
+        return -EINVAL;
+    }
+
+    if (len > sizeof(struct zmk_behavior_binding_setting)) {
+        LOG_ERR("Too large binding setting size (got %d expected %d)", len,
+                sizeof(struct zmk_behavior_binding_setting));
+        return -EINVAL;
+    }
+
+    if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
+        LOG_WRN("Layer %d is larger than max of %d", layer, ZMK_KEYMAP_LAYERS_LEN);
+        return -EINVAL;
+    }
+
+    if (key_position >= ZMK_KEYMAP_LEN) {
+        LOG_WRN("Key position %d is larger than max of %d", key_position, ZMK_KEYMAP_LEN);
+        return -EINVAL;
+    }
+
+    struct zmk_behavior_binding_setting binding_setting = {0};
+    int err = read_cb(cb_arg, &binding_setting, len);
+    if (err <= 0) {
+        LOG_ERR("Failed to handle keymap binding from settings (err %d)", err);
+        return err;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+    WRITE_BIT(legacy_binding_positions[layer][key_position / 8], key_position % 8, 1);
+
+    // The layer blob holds the latest bindings, and may have been loaded before this key
+    if (zmk_keymap_layers_state_test(blob_loaded_layers, layer)) {
+        return 0;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+
+    return apply_binding_setting(layer, key_position, &binding_setting);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+
+static int load_layer_blob_setting(const char *next, size_t len, settings_read_cb read_cb,
+                                   void *cb_arg) {
+    char *endptr;
+    zmk_keymap_layer_id_t layer = strtoul(next, &endptr, 10);
+    if (*endptr != '\0') {
+        LOG_WRN("Invalid layer number: %s with endptr %s", next, endptr);
+        return -EINVAL;
+    }
+
+    if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
+        LOG_WRN("Layer %d is larger than max of %d", layer, ZMK_KEYMAP_LAYERS_LEN);
+        return -EINVAL;
+    }
+
+    if (len < LAYER_BLOB_HEADER_SIZE || len > sizeof(layer_blob)) {
+        LOG_ERR("Invalid layer blob setting size %d", len);
+        return -EINVAL;
+    }
+
+    int ret = read_cb(cb_arg, &layer_blob, len);
+    if (ret <= 0) {
+        LOG_ERR("Failed to handle keymap layer blob from settings (err %d)", ret);
+        return ret;
+    }
+
+    if (layer_blob.version != LAYER_BLOB_VERSION) {
+        LOG_WRN("Unsupported keymap layer blob version %d for layer %d", layer_blob.version,
+                layer);
+        return -EINVAL;
+    }
+
+    if ((ret - LAYER_BLOB_HEADER_SIZE) % sizeof(struct zmk_keymap_layer_blob_entry) != 0) {
+        LOG_ERR("Truncated keymap layer blob for layer %d", layer);
+        return -EINVAL;
+    }
+
+    // The blob holds every binding of the layer that differs from the stock keymap, so start
+    // from the stock layer in case older per binding settings were loaded first.
+    for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
+        keymap_write_binding(layer, k, &zmk_stock_keymap[layer][k]);
+    }
+
+    size_t count = (ret - LAYER_BLOB_HEADER_SIZE) / sizeof(struct zmk_keymap_layer_blob_entry);
+    for (size_t i = 0; i < count; i++) {
+        int err = apply_binding_setting(layer, layer_blob.entries[i].position,
+                                        &layer_blob.entries[i].binding);
+        if (err < 0) {
+            return err;
+        }
+    }
+
+    zmk_keymap_layers_state_write(&blob_loaded_layers, layer, true);
+    invalidate_resolved_layers();
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+
 static int keymap_handle_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
     const char *next;
 
@@ -854,60 +1687,13 @@ static int keymap_handle_set(const char *name, size_t len, settings_read_cb read
 
         zmk_keymap_layer_names[layer][ret] = 0;
     } else if (settings_name_steq(name, "l", &next) && next) {
-        char *endptr;
-        uint8_t layer = strtoul(next, &endptr, 10);
-        if (*endptr != '/') {
-            LOG_WRN("Invalid layer number: %s with endptr %s", next, endptr);
-            return -EINVAL;
-        }
-
-        uint8_t key_position = strtoul(endptr + 1, &endptr, 10);
-
-        if (*endptr != '\0') {
-            LOG_WRN("Invalid key_position number: %s with endptr %s", next, endptr);
-            return -EINVAL;
-        }
-
-        if (len > sizeof(struct zmk_behavior_binding_setting)) {
-            LOG_ERR("Too large binding setting size (got %d expected %d)", len,
-                    sizeof(struct zmk_behavior_binding_setting));
-            return -EINVAL;
-        }
-
-        if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
-            LOG_WRN("Layer %d is larger than max of %d", layer, ZMK_KEYMAP_LAYERS_LEN);
-            return -EINVAL;
-        }
-
-        if (key_position >= ZMK_KEYMAP_LEN) {
-            LOG_WRN("Key position %d is larger than max of %d", key_position, ZMK_KEYMAP_LEN);
-            return -EINVAL;
-        }
-
-        struct zmk_behavior_binding_setting binding_setting = {0};
-        int err = read_cb(cb_arg, &binding_setting, len);
-        if (err <= 0) {
-            LOG_ERR("Failed to handle keymap binding from settings (err %d)", err);
-            return err;
-        }
-
-        const char *name =
-            zmk_behavior_find_behavior_name_from_local_id(binding_setting.behavior_local_id);
-
-        if (!name) {
-            LOG_WRN("Loaded device %d from settings but no device found by that local ID",
-                    binding_setting.behavior_local_id);
-        }
-
-        zmk_keymap[layer][key_position] = (struct zmk_behavior_binding){
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
-            .local_id = binding_setting.behavior_local_id,
-#endif
-            .behavior_dev = name,
-            .param1 = binding_setting.param1,
-            .param2 = binding_setting.param2,
-        };
+        return load_binding_setting(next, len, read_cb, cb_arg);
+    }
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+    else if (settings_name_steq(name, "lb", &next) && next) {
+        return load_layer_blob_setting(next, len, read_cb, cb_arg);
     }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
     else if (settings_name_steq(name, "layer_order", &next) && !next) {
         int err =
@@ -922,14 +1708,59 @@ static int keymap_handle_set(const char *name, size_t len, settings_read_cb read
 
         memcpy(keymap_layer_orders, settings_layer_orders,
                MIN(len, ARRAY_SIZE(settings_layer_orders)));
+        invalidate_resolved_layers();
     }
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
     return 0;
 };
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
+static int keymap_reload_binding_settings(const char *key, size_t len, settings_read_cb read_cb,
+                                          void *cb_arg, void *param) {
+    const char *next;
+    if (settings_name_steq(key, "l", &next) && next) {
+        return load_binding_setting(next, len, read_cb, cb_arg);
+    }
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+    else if (settings_name_steq(key, "lb", &next) && next) {
+        return load_layer_blob_setting(next, len, read_cb, cb_arg);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_BLOBS)
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+
 static int keymap_handle_commit(void) {
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
+    if (keymap_unresolved_bindings) {
+        keymap_unresolved_bindings = false;
+
+        int err = settings_load_subtree_direct("keymap", keymap_reload_binding_settings, NULL);
+        if (err < 0) {
+            LOG_ERR("Failed to reload keymap bindings after settings load (err %d)", err);
+        }
+    }
+#elif IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS) &&                                            \
+    IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+    for (size_t i = 0; i < keymap_overlay_len; i++) {
+        struct zmk_behavior_binding *binding = &keymap_overlay[i].binding;
+
+        if (binding->local_id > 0 && !binding->behavior_dev) {
+            binding->behavior_dev = zmk_behavior_find_behavior_name_from_local_id(binding->local_id);
+
+            if (!binding->behavior_dev) {
+                LOG_ERR("Failed to finding device for local ID %d after settings load",
+                        binding->local_id);
+            }
+
+            zmk_behavior_resolve_binding_device(binding);
+        }
+    }
+#elif IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
         for (int p = 0; p < ZMK_KEYMAP_LEN; p++) {
             struct zmk_behavior_binding *binding = &zmk_keymap[l][p];
@@ -942,11 +1773,15 @@ static int keymap_handle_commit(void) {
                     LOG_ERR("Failed to finding device for local ID %d after settings load",
                             binding->local_id);
                 }
+
+                zmk_behavior_resolve_binding_device(binding);
             }
         }
     }
 #endif
 
+    invalidate_resolved_layers();
+
     return 0;
 }
 
@@ -955,13 +1790,44 @@ SETTINGS_STATIC_HANDLER_DEFINE(keymap, "keymap", NULL, keymap_handle_set, keymap
 
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+
+static void resolve_keymap_binding_devices(void) {
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        // Compact bindings look up their device directly when they are unpacked, and overlay
+        // bindings are resolved when they are stored
+#if !IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS) &&                                             \
+    !IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)
+        for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
+            int err = zmk_behavior_resolve_binding_device(&zmk_keymap[l][k]);
+            if (err < 0) {
+                LOG_WRN("Failed to resolve behavior %s at %d on layer %d (%d)",
+                        zmk_keymap[l][k].behavior_dev, k, l, err);
+            }
+        }
+#endif // !IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS) && ...
+
+#if ZMK_KEYMAP_HAS_SENSORS
+        for (int s = 0; s < ZMK_KEYMAP_SENSORS_LEN; s++) {
+            zmk_behavior_resolve_binding_device(&zmk_sensor_keymap[l][s]);
+        }
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+
 int keymap_init(void) {
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
     load_stock_keymap_layer_ordering();
 #endif
-#if IS_ENABLED(CONFIG_ZMK_STUDIO)
+#if (IS_ENABLED(CONFIG_ZMK_STUDIO) && !IS_ENABLED(CONFIG_ZMK_KEYMAP_OVERLAY_BINDINGS)) ||          \
+    IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT_BINDINGS)
     reload_from_stock_keymap();
 #endif
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_DEVICES_IN_BINDINGS)
+    resolve_keymap_binding_devices();
+#endif
 
     return 0;
 }
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/latency_probe.h>
+
+#define BUCKET_US CONFIG_ZMK_LATENCY_PROBE_BUCKET_US
+#define BUCKETS CONFIG_ZMK_LATENCY_PROBE_BUCKETS
+#define TRANSPORTS (ZMK_TRANSPORT_BLE + 1)
+
+struct transport_latency {
+    uint32_t last_origin;
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    // The last bucket collects every sample at or above BUCKETS - 1 bucket widths.
+    uint32_t histogram[BUCKETS];
+};
+
+static struct transport_latency latencies[TRANSPORTS];
+static K_SPINLOCK_DEFINE(lock);
+
+static uint32_t current_origin;
+
+static const char *transport_name(enum zmk_transport transport) {
+    switch (transport) {
+    case ZMK_TRANSPORT_USB:
+        return "USB";
+    case ZMK_TRANSPORT_BLE:
+        return "BLE";
+    default:
+        return "Unknown";
+    }
+}
+
+uint32_t zmk_latency_probe_stamp(void) {
+    uint32_t now = k_cycle_get_32();
+    return now ? now : 1;
+}
+
+uint32_t zmk_latency_probe_set_origin(uint32_t origin) {
+    uint32_t previous = current_origin;
+    current_origin = origin;
+    return previous;
+}
+
+uint32_t zmk_latency_probe_get_origin(void) { return current_origin; }
+
+void zmk_latency_probe_record(enum zmk_transport transport, uint32_t origin) {
+    if (origin == 0 || transport >= TRANSPORTS) {
+        return;
+    }
+
+    uint32_t elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - origin);
+
+    // Reports for BLE are sent from the HoG work queue, so guard against concurrent updates.
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    struct transport_latency *lat = &latencies[transport];
+
+    if (lat->last_origin != origin) {
+        lat->last_origin = origin;
+        lat->min_us = lat->count == 0 ? elapsed_us : MIN(lat->min_us, elapsed_us);
+        lat->max_us = MAX(lat->max_us, elapsed_us);
+        lat->total_us += elapsed_us;
+        lat->count++;
+        lat->histogram[MIN(elapsed_us / BUCKET_US, BUCKETS - 1)]++;
+    }
+
+    k_spin_unlock(&lock, key);
+}
+
+int zmk_latency_probe_get_stats(enum zmk_transport transport,
+                                struct zmk_latency_probe_stats *stats) {
+    if (transport >= TRANSPORTS) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    const struct transport_latency *lat = &latencies[transport];
+
+    *stats = (struct zmk_latency_probe_stats){
+        .count = lat->count,
+        .min_us = lat->min_us,
+        .max_us = lat->max_us,
+        .avg_us = lat->count ? (uint32_t)(lat->total_us / lat->count) : 0,
+    };
+
+    uint32_t p99_rank = lat->count - (lat->count / 100);
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKETS && lat->count > 0; i++) {
+        seen += lat->histogram[i];
+        if (seen >= p99_rank) {
+            stats->p99_us = (i == BUCKETS - 1) ? lat->max_us : (i + 1) * BUCKET_US;
+            break;
+        }
+    }
+
+    k_spin_unlock(&lock, key);
+
+    return 0;
+}
+
+void zmk_latency_probe_log(void) {
+    for (int t = 0; t < TRANSPORTS; t++) {
+        struct zmk_latency_probe_stats stats;
+
+        zmk_latency_probe_get_stats(t, &stats);
+        if (stats.count == 0) {
+            continue;
+        }
+
+        LOG_INF("%s keypress to report latency: %d samples, min %dus, avg %dus, p99 %dus, max %dus",
+                transport_name(t), stats.count, stats.min_us, stats.avg_us, stats.p99_us,
+                stats.max_us);
+    }
+}
+
+void zmk_latency_probe_reset(void) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    memset(latencies, 0, sizeof(latencies));
+    k_spin_unlock(&lock, key);
+}
+
+#if CONFIG_ZMK_LATENCY_PROBE_LOG_INTERVAL_SEC > 0
+
+static void latency_probe_log_work_cb(struct k_work *work) {
+    zmk_latency_probe_log();
+    k_work_schedule(k_work_delayable_from_work(work),
+                    K_SECONDS(CONFIG_ZMK_LATENCY_PROBE_LOG_INTERVAL_SEC));
+}
+
+static K_WORK_DELAYABLE_DEFINE(latency_probe_log_work, latency_probe_log_work_cb);
+
+static int latency_probe_init(void) {
+    k_work_schedule(&latency_probe_log_work, K_SECONDS(CONFIG_ZMK_LATENCY_PROBE_LOG_INTERVAL_SEC));
+    return 0;
+}
+
+SYS_INIT(latency_probe_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif // CONFIG_ZMK_LATENCY_PROBE_LOG_INTERVAL_SEC > 0
@@ -23,6 +23,10 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
 
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+#include <zmk/latency_probe.h>
+#endif
+
 ZMK_EVENT_IMPL(zmk_physical_layout_selection_changed);
 
 #define DT_DRV_COMPAT zmk_physical_layout
@@ -171,6 +175,9 @@ struct zmk_kscan_event {
     uint32_t row;
     uint32_t column;
     uint32_t state;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    uint32_t probe_origin;
+#endif
 };
 
 static struct zmk_kscan_msg_processor {
@@ -189,7 +196,11 @@ static void zmk_physical_layout_kscan_callback(const struct device *dev, uint32_
     struct zmk_kscan_event ev = {
         .row = row,
         .column = column,
-        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED)};
+        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED),
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        .probe_origin = zmk_latency_probe_stamp(),
+#endif
+    };
 
     k_msgq_put(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT);
     k_work_submit(&msg_processor.work);
@@ -215,7 +226,11 @@ static void zmk_physical_layouts_kscan_process_msgq(struct k_work *item) {
             (struct zmk_position_state_changed){.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
                                                 .state = pressed,
                                                 .position = position,
-                                                .timestamp = k_uptime_get()});
+                                                .timestamp = k_uptime_get(),
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+                                                .probe_origin = ev.probe_origin,
+#endif
+            });
     }
 }
 
@@ -354,7 +369,16 @@ int zmk_physical_layouts_save_selected(void) {
 #endif
 }
 
-int zmk_physical_layouts_revert_selected(void) { return zmk_physical_layouts_select_initial(); }
+int zmk_physical_layouts_revert_selected(void) {
+    int ret = zmk_physical_layouts_select_initial();
+
+    if (ret >= 0) {
+        raise_zmk_physical_layout_selection_changed((struct zmk_physical_layout_selection_changed){
+            .selection = zmk_physical_layouts_get_selected()});
+    }
+
+    return ret;
+}
 
 int zmk_physical_layouts_get_position_map(uint8_t source, uint8_t dest, size_t map_size,
                                           uint32_t map[map_size]) {
@@ -56,7 +56,7 @@ struct input_listener_config_entry {
 };
 
 struct input_listener_layer_override {
-    uint32_t layer_mask;
+    zmk_keymap_layers_state_t layer_mask;
     bool process_next;
     struct input_listener_config_entry config;
 };
@@ -210,10 +210,10 @@ static int filter_with_input_config(const struct input_listener_config *cfg,
     for (size_t oi = 0; oi < cfg->layer_overrides_len; oi++) {
         const struct input_listener_layer_override *override = &cfg->layer_overrides[oi];
         struct input_listener_processor_data *override_data = &data->layer_override_data[oi];
-        uint32_t mask = override->layer_mask;
-        uint8_t layer = 0;
-        while (mask != 0) {
-            if (mask & BIT(0) && zmk_keymap_layer_active(layer)) {
+        int highest_layer = zmk_keymap_layers_state_highest(override->layer_mask);
+        for (int layer = 0; layer <= highest_layer; layer++) {
+            if (zmk_keymap_layers_state_test(override->layer_mask, layer) &&
+                zmk_keymap_layer_active(layer)) {
                 int ret =
                     apply_config(cfg->listener_index, &override->config, override_data, data, evt);
 
@@ -224,9 +224,6 @@ static int filter_with_input_config(const struct input_listener_config *cfg,
                     return 0;
                 }
             }
-
-            layer++;
-            mask = mask >> 1;
         }
     }
 
@@ -362,11 +359,9 @@ static void input_handler(const struct input_listener_config *config,
 
 #define CHILD_CONFIG(node, parent) SCOPED_PROCESSOR(node, node, parent)
 
-#define OVERRIDE_LAYER_BIT(node, prop, idx) BIT(DT_PROP_BY_IDX(node, prop, idx))
-
 #define IL_OVERRIDE(node, parent)                                                                  \
     {                                                                                              \
-        .layer_mask = DT_FOREACH_PROP_ELEM_SEP(node, layers, OVERRIDE_LAYER_BIT, (|)),             \
+        .layer_mask = ZMK_KEYMAP_LAYERS_STATE_DT_PROP(node, layers),                               \
         .process_next = DT_PROP_OR(node, process_next, false),                                     \
         .config = IL_EXTRACT_CONFIG(node, parent, node),                                           \
     }
@@ -12,6 +12,7 @@
 #include <zephyr/logging/log.h>
 #include <zmk/keymap.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_timer.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
 
@@ -37,8 +38,8 @@ struct temp_layer_data {
     struct temp_layer_state state;
 };
 
-/* Static Work Queue Items */
-static struct k_work_delayable layer_disable_works[MAX_LAYERS];
+/* Static Timers */
+static struct zmk_behavior_timer layer_disable_timers[MAX_LAYERS];
 
 /* Position Search */
 static bool position_is_excluded(const struct temp_layer_config *config, uint32_t position) {
@@ -78,10 +79,9 @@ static void update_layer_state(struct temp_layer_state *state, bool activate) {
     }
 }
 
-/* Work Queue Callback */
-static void layer_disable_callback(struct k_work *work) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
-    int layer_index = ARRAY_INDEX(layer_disable_works, d_work);
+/* Timer Callback */
+static void layer_disable_callback(struct zmk_behavior_timer *timer) {
+    int layer_index = ARRAY_INDEX(layer_disable_timers, timer);
 
     const struct device *dev = DEVICE_DT_INST_GET(0);
     struct temp_layer_data *data = (struct temp_layer_data *)dev->data;
@@ -159,7 +159,7 @@ static int temp_layer_handle_event(const struct device *dev, struct input_event
     }
 
     if (param2 > 0) {
-        k_work_reschedule(&layer_disable_works[param1], K_MSEC(param2));
+        zmk_behavior_timer_start(&layer_disable_timers[param1], k_uptime_get() + param2);
     }
 
     return ZMK_INPUT_PROC_CONTINUE;
@@ -167,7 +167,7 @@ static int temp_layer_handle_event(const struct device *dev, struct input_event
 
 static int temp_layer_init(const struct device *dev) {
     for (int i = 0; i < MAX_LAYERS; i++) {
-        k_work_init_delayable(&layer_disable_works[i], layer_disable_callback);
+        zmk_behavior_timer_init(&layer_disable_timers[i], layer_disable_callback);
     }
 
     return 0;
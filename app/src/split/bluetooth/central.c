@@ -23,19 +23,27 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/ble.h>
 #include <zmk/behavior.h>
 #include <zmk/sensors.h>
+#include <zmk/split/bluetooth/central.h>
 #include <zmk/split/bluetooth/uuid.h>
 #include <zmk/split/bluetooth/service.h>
+#include <zmk/split/bluetooth/peripheral_positions.h>
+#include <zmk/split/bluetooth/event_ring.h>
 #include <zmk/event_manager.h>
+#include <zmk/activity.h>
+#include <zmk/events/activity_state_changed.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/sensor_event.h>
 #include <zmk/events/battery_state_changed.h>
 #include <zmk/pointing/input_split.h>
 #include <zmk/hid_indicators_types.h>
+#include <zmk/matrix.h>
 #include <zmk/physical_layouts.h>
 
 static int start_scanning(void);
 
-#define POSITION_STATE_DATA_LEN 16
+// Enough for a peripheral with every position in the keymap, in whole words so that changes can
+// be found a word at a time.
+#define PERIPHERAL_POSITIONS_LEN ROUND_UP(ZMK_SPLIT_POS_STATE_LEN(ZMK_KEYMAP_LEN), sizeof(uint32_t))
 
 enum peripheral_slot_state {
     PERIPHERAL_SLOT_STATE_OPEN,
@@ -48,8 +56,10 @@ struct peripheral_slot {
     struct bt_conn *conn;
     struct bt_gatt_discover_params discover_params;
     struct bt_gatt_subscribe_params subscribe_params;
+    struct bt_gatt_subscribe_params events_subscribe_params;
     struct bt_gatt_subscribe_params sensor_subscribe_params;
     struct bt_gatt_discover_params sub_discover_params;
+    struct bt_gatt_discover_params events_sub_discover_params;
     uint16_t run_behavior_handle;
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
     struct bt_gatt_subscribe_params batt_lvl_subscribe_params;
@@ -59,8 +69,15 @@ struct peripheral_slot {
     uint16_t update_hid_indicators;
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
     uint16_t selected_physical_layout_handle;
-    uint8_t position_state[POSITION_STATE_DATA_LEN];
-    uint8_t changed_positions[POSITION_STATE_DATA_LEN];
+    struct bt_gatt_read_params num_of_positions_read_params;
+    // The length of the peripheral's position state, once it has told us its number of positions.
+    uint16_t position_state_len;
+    uint8_t position_state[PERIPHERAL_POSITIONS_LEN];
+    struct zmk_split_peripheral_positions positions;
+    struct bt_gatt_read_params position_state_read_params;
+    uint8_t read_position_state[PERIPHERAL_POSITIONS_LEN];
+    bool reading_position_state;
+    struct zmk_split_bt_conn_params conn_params;
 };
 
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
@@ -134,18 +151,112 @@ static bool is_scanning = false;
 
 static const struct bt_uuid_128 split_service_uuid = BT_UUID_INIT_128(ZMK_SPLIT_BT_SERVICE_UUID);
 
-K_MSGQ_DEFINE(peripheral_event_msgq, sizeof(struct zmk_position_state_changed),
-              CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE, 4);
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+
+struct zmk_input_event_msg {
+    uint8_t reg;
+    struct zmk_split_input_event_payload payload;
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+
+// Everything received from peripherals goes through one queue, so events are raised in the order
+// they arrived, whatever their type.
+struct peripheral_event {
+    enum zmk_split_central_event_type type;
+    union {
+        struct zmk_position_state_changed position;
+#if ZMK_KEYMAP_HAS_SENSORS
+        struct zmk_sensor_event sensor;
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+        struct zmk_input_event_msg input;
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
+        struct zmk_peripheral_battery_state_changed battery;
+#endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
+    };
+};
+
+#if ZMK_KEYMAP_HAS_SENSORS || IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+#define PERIPHERAL_INPUT_QUEUE_SIZE CONFIG_ZMK_SPLIT_BLE_CENTRAL_INPUT_QUEUE_SIZE
+#else
+#define PERIPHERAL_INPUT_QUEUE_SIZE 0
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
+#define PERIPHERAL_BATTERY_QUEUE_SIZE CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_QUEUE_SIZE
+#else
+#define PERIPHERAL_BATTERY_QUEUE_SIZE 0
+#endif
+
+#define PERIPHERAL_EVENT_QUEUE_SIZE                                                                \
+    (CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE + PERIPHERAL_INPUT_QUEUE_SIZE +              \
+     PERIPHERAL_BATTERY_QUEUE_SIZE)
+
+// Events are only queued from Bluetooth callbacks, which all run on the Bluetooth receive thread,
+// and only taken off by peripheral_event_work, so the ring has a single producer and consumer.
+// Slots are reserved for position events, so a burst of sensor or input events can't push out a
+// key release and leave the key stuck.
+ZMK_SPLIT_EVENT_RING_DEFINE_RESERVED(peripheral_event_queue, struct peripheral_event,
+                                     PERIPHERAL_EVENT_QUEUE_SIZE,
+                                     ZMK_SPLIT_CENTRAL_EVENT_TYPE_COUNT,
+                                     CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE,
+                                     ZMK_SPLIT_CENTRAL_EVENT_POSITION);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_EVENT_QUEUE_DEDICATED)
+
+K_THREAD_STACK_DEFINE(peripheral_event_q_stack,
+                      CONFIG_ZMK_SPLIT_BLE_CENTRAL_EVENT_DEDICATED_THREAD_STACK_SIZE);
 
-void peripheral_event_work_callback(struct k_work *work) {
-    struct zmk_position_state_changed ev;
-    while (k_msgq_get(&peripheral_event_msgq, &ev, K_NO_WAIT) == 0) {
-        LOG_DBG("Trigger key position state change for %d", ev.position);
-        raise_zmk_position_state_changed(ev);
+static struct k_work_q peripheral_event_q;
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_EVENT_QUEUE_DEDICATED)
+
+static struct k_work_q *peripheral_event_work_q(void) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_EVENT_QUEUE_DEDICATED)
+    return &peripheral_event_q;
+#else
+    return &k_sys_work_q;
+#endif
+}
+
+static void peripheral_event_work_callback(struct k_work *work);
+
+static K_WORK_DEFINE(peripheral_event_work, peripheral_event_work_callback);
+
+static int queue_peripheral_event(const struct peripheral_event *ev) {
+    int err = zmk_split_event_ring_put(&peripheral_event_queue, ev, ev->type);
+    if (err < 0) {
+        return err;
     }
+
+    k_work_submit_to_queue(peripheral_event_work_q(), &peripheral_event_work);
+    return 0;
 }
 
-K_WORK_DEFINE(peripheral_event_work, peripheral_event_work_callback);
+int zmk_split_bt_central_get_event_drops(enum zmk_split_central_event_type type,
+                                         uint32_t *drops) {
+    if (type >= ZMK_SPLIT_CENTRAL_EVENT_TYPE_COUNT) {
+        return -EINVAL;
+    }
+
+    *drops = zmk_split_event_ring_get_drops(&peripheral_event_queue, type);
+    return 0;
+}
+
+static void queue_peripheral_position_event(uint32_t position, bool pressed, int64_t timestamp,
+                                            void *user_data) {
+    struct peripheral_slot *slot = user_data;
+
+    queue_peripheral_event(&(struct peripheral_event){
+        .type = ZMK_SPLIT_CENTRAL_EVENT_POSITION,
+        .position = {.source = slot - peripherals,
+                     .position = position,
+                     .state = pressed,
+                     .timestamp = timestamp},
+    });
+}
 
 int peripheral_slot_index_for_conn(struct bt_conn *conn) {
     for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
@@ -186,28 +297,16 @@ int release_peripheral_slot(int index) {
     slot->state = PERIPHERAL_SLOT_STATE_OPEN;
 
     // Raise events releasing any active positions from this peripheral
-    for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (slot->position_state[i] & BIT(j)) {
-                uint32_t position = (i * 8) + j;
-                struct zmk_position_state_changed ev = {.source = index,
-                                                        .position = position,
-                                                        .state = false,
-                                                        .timestamp = k_uptime_get()};
-
-                k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
-            }
-        }
-    }
+    static const uint8_t released_state[PERIPHERAL_POSITIONS_LEN];
+    zmk_split_peripheral_positions_set_state(&slot->positions, released_state, k_uptime_get(),
+                                             queue_peripheral_position_event, slot);
+    zmk_split_peripheral_positions_reset(&slot->positions);
 
-    for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
-        slot->position_state[i] = 0U;
-        slot->changed_positions[i] = 0U;
-    }
+    slot->reading_position_state = false;
 
     // Clean up previously discovered handles;
     slot->subscribe_params.value_handle = 0;
+    slot->events_subscribe_params.value_handle = 0;
     slot->run_behavior_handle = 0;
     slot->selected_physical_layout_handle = 0;
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
@@ -224,6 +323,8 @@ int reserve_peripheral_slot(const bt_addr_le_t *addr) {
             // Be sure the slot is fully reinitialized.
             release_peripheral_slot(i);
             peripherals[i].state = PERIPHERAL_SLOT_STATE_CONNECTING;
+            // Until the peripheral says how many positions it has.
+            peripherals[i].position_state_len = ZMK_SPLIT_POS_STATE_MIN_LEN;
             return i;
         }
     }
@@ -251,19 +352,6 @@ int confirm_peripheral_slot_conn(struct bt_conn *conn) {
 }
 
 #if ZMK_KEYMAP_HAS_SENSORS
-K_MSGQ_DEFINE(peripheral_sensor_event_msgq, sizeof(struct zmk_sensor_event),
-              CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE, 4);
-
-void peripheral_sensor_event_work_callback(struct k_work *work) {
-    struct zmk_sensor_event ev;
-    while (k_msgq_get(&peripheral_sensor_event_msgq, &ev, K_NO_WAIT) == 0) {
-        LOG_DBG("Trigger sensor change for %d", ev.sensor_index);
-        raise_zmk_sensor_event(ev);
-    }
-}
-
-K_WORK_DEFINE(peripheral_sensor_event_work, peripheral_sensor_event_work_callback);
-
 static uint8_t split_central_sensor_notify_func(struct bt_conn *conn,
                                                 struct bt_gatt_subscribe_params *params,
                                                 const void *data, uint16_t length) {
@@ -282,15 +370,17 @@ static uint8_t split_central_sensor_notify_func(struct bt_conn *conn,
 
     struct sensor_event sensor_event;
     memcpy(&sensor_event, data, MIN(length, sizeof(sensor_event)));
-    struct zmk_sensor_event ev = {
-        .sensor_index = sensor_event.sensor_index,
-        .channel_data_size = MIN(sensor_event.channel_data_size, ZMK_SENSOR_EVENT_MAX_CHANNELS),
-        .timestamp = k_uptime_get()};
-
-    memcpy(ev.channel_data, sensor_event.channel_data,
-           sizeof(struct zmk_sensor_channel_data) * sensor_event.channel_data_size);
-    k_msgq_put(&peripheral_sensor_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_sensor_event_work);
+    struct peripheral_event ev = {
+        .type = ZMK_SPLIT_CENTRAL_EVENT_SENSOR,
+        .sensor = {.sensor_index = sensor_event.sensor_index,
+                   .channel_data_size =
+                       MIN(sensor_event.channel_data_size, ZMK_SENSOR_EVENT_MAX_CHANNELS),
+                   .timestamp = k_uptime_get()},
+    };
+
+    memcpy(ev.sensor.channel_data, sensor_event.channel_data,
+           sizeof(struct zmk_sensor_channel_data) * ev.sensor.channel_data_size);
+    queue_peripheral_event(&ev);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -298,27 +388,6 @@ static uint8_t split_central_sensor_notify_func(struct bt_conn *conn,
 
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
 
-struct zmk_input_event_msg {
-    uint8_t reg;
-    struct zmk_split_input_event_payload payload;
-};
-
-K_MSGQ_DEFINE(peripheral_input_event_msgq, sizeof(struct zmk_input_event_msg), 5, 4);
-//   CONFIG_ZMK_SPLIT_BLE_CENTRAL_INPUT_QUEUE_SIZE, 4);
-
-void peripheral_input_event_work_callback(struct k_work *work) {
-    struct zmk_input_event_msg msg;
-    while (k_msgq_get(&peripheral_input_event_msgq, &msg, K_NO_WAIT) == 0) {
-        int ret = zmk_input_split_report_peripheral_event(
-            msg.reg, msg.payload.type, msg.payload.code, msg.payload.value, msg.payload.sync);
-        if (ret < 0) {
-            LOG_WRN("Failed to report peripheral event %d", ret);
-        }
-    }
-}
-
-K_WORK_DEFINE(input_event_work, peripheral_input_event_work_callback);
-
 static uint8_t peripheral_input_event_notify_cb(struct bt_conn *conn,
                                                 struct bt_gatt_subscribe_params *params,
                                                 const void *data, uint16_t length) {
@@ -335,6 +404,7 @@ static uint8_t peripheral_input_event_notify_cb(struct bt_conn *conn,
         return BT_GATT_ITER_STOP;
     }
 
+    struct peripheral_event ev = {.type = ZMK_SPLIT_CENTRAL_EVENT_INPUT};
     struct zmk_input_event_msg msg;
 
     memcpy(&msg.payload, data, MIN(length, sizeof(struct zmk_split_input_event_payload)));
@@ -345,8 +415,8 @@ static uint8_t peripheral_input_event_notify_cb(struct bt_conn *conn,
     for (size_t i = 0; i < ARRAY_SIZE(peripheral_input_slots); i++) {
         if (&peripheral_input_slots[i].sub == params) {
             msg.reg = peripheral_input_slots[i].reg;
-            k_msgq_put(&peripheral_input_event_msgq, &msg, K_NO_WAIT);
-            k_work_submit(&input_event_work);
+            ev.input = msg;
+            queue_peripheral_event(&ev);
         }
     }
 
@@ -373,27 +443,144 @@ static uint8_t split_central_notify_func(struct bt_conn *conn,
 
     LOG_DBG("[NOTIFICATION] data %p length %u", data, length);
 
-    for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
-        slot->changed_positions[i] = ((uint8_t *)data)[i] ^ slot->position_state[i];
-        slot->position_state[i] = ((uint8_t *)data)[i];
-        LOG_DBG("data: %d", slot->position_state[i]);
-    }
-
-    for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (slot->changed_positions[i] & BIT(j)) {
-                uint32_t position = (i * 8) + j;
-                bool pressed = slot->position_state[i] & BIT(j);
-                struct zmk_position_state_changed ev = {.source =
-                                                            peripheral_slot_index_for_conn(conn),
-                                                        .position = position,
-                                                        .state = pressed,
-                                                        .timestamp = k_uptime_get()};
-
-                k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
-            }
+    size_t state_len = slot->position_state_len;
+    if (length < state_len) {
+        LOG_WRN("Ignoring position state of %u bytes", length);
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    // Older peripherals only send the position state, so their changes are stamped on arrival.
+    int64_t timestamp = k_uptime_get();
+    if (length == state_len + ZMK_SPLIT_POS_STATE_TIMESTAMP_LEN) {
+        timestamp = zmk_split_peripheral_clock_to_uptime(
+            &slot->positions.clock, timestamp, sys_get_le16((const uint8_t *)data + state_len));
+    }
+
+    // Positions the keymap doesn't have are left out.
+    uint8_t state[PERIPHERAL_POSITIONS_LEN];
+    memcpy(state, slot->position_state, sizeof(state));
+    memcpy(state, data, MIN(state_len, sizeof(state)));
+
+    zmk_split_peripheral_positions_set_state(&slot->positions, state, timestamp,
+                                             queue_peripheral_position_event, slot);
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+static uint8_t split_central_position_state_read_func(struct bt_conn *conn, uint8_t err,
+                                                      struct bt_gatt_read_params *params,
+                                                      const void *data, uint16_t length) {
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+    if (slot == NULL) {
+        return BT_GATT_ITER_STOP;
+    }
+
+    if (err > 0) {
+        LOG_ERR("Error during reading position state: %d", err);
+        slot->reading_position_state = false;
+        return BT_GATT_ITER_STOP;
+    }
+
+    // Long position states arrive in several parts.
+    if (data != NULL) {
+        uint16_t offset = params->single.offset;
+        if (offset < sizeof(slot->read_position_state)) {
+            memcpy(&slot->read_position_state[offset], data,
+                   MIN(length, sizeof(slot->read_position_state) - offset));
         }
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    slot->reading_position_state = false;
+
+    zmk_split_peripheral_positions_set_state(&slot->positions, slot->read_position_state,
+                                             k_uptime_get(), queue_peripheral_position_event,
+                                             slot);
+
+    return BT_GATT_ITER_STOP;
+}
+
+// Catches up with the peripheral after position events were lost. Any events still on their way
+// only repeat states it has already read, so they are skipped.
+static void read_peripheral_position_state(struct peripheral_slot *slot) {
+    if (slot->reading_position_state || slot->subscribe_params.value_handle == 0) {
+        return;
+    }
+
+    memcpy(slot->read_position_state, slot->position_state, sizeof(slot->read_position_state));
+
+    slot->position_state_read_params = (struct bt_gatt_read_params){
+        .func = split_central_position_state_read_func,
+        .handle_count = 1,
+        .single = {.handle = slot->subscribe_params.value_handle, .offset = 0},
+    };
+
+    int err = bt_gatt_read(slot->conn, &slot->position_state_read_params);
+    if (err < 0) {
+        LOG_ERR("Failed to read the position state (err %d)", err);
+        return;
+    }
+
+    slot->reading_position_state = true;
+}
+
+static uint8_t split_central_num_of_positions_read_func(struct bt_conn *conn, uint8_t err,
+                                                        struct bt_gatt_read_params *params,
+                                                        const void *data, uint16_t length) {
+    if (err > 0) {
+        LOG_ERR("Error during reading number of positions: %d", err);
+        return BT_GATT_ITER_STOP;
+    }
+
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+    if (slot == NULL || data == NULL || length == 0) {
+        return BT_GATT_ITER_STOP;
+    }
+
+    uint16_t num_of_positions =
+        length >= sizeof(uint16_t) ? sys_get_le16(data) : *(const uint8_t *)data;
+    slot->position_state_len = ZMK_SPLIT_POS_STATE_LEN(num_of_positions);
+
+    LOG_DBG("Peripheral has %d positions", num_of_positions);
+    if (num_of_positions > PERIPHERAL_POSITIONS_LEN * 8) {
+        LOG_WRN("Peripheral has %d positions, more than the keymap", num_of_positions);
+    }
+
+    return BT_GATT_ITER_STOP;
+}
+
+static uint8_t split_central_events_notify_func(struct bt_conn *conn,
+                                                struct bt_gatt_subscribe_params *params,
+                                                const void *data, uint16_t length) {
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+
+    if (slot == NULL) {
+        LOG_ERR("No peripheral state found for connection");
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    if (!data) {
+        LOG_DBG("[UNSUBSCRIBED]");
+        params->value_handle = 0U;
+        return BT_GATT_ITER_STOP;
+    }
+
+    LOG_DBG("[NOTIFICATION] data %p length %u", data, length);
+
+    const size_t header_len = offsetof(struct zmk_split_position_events_payload, events);
+    if (length < header_len) {
+        LOG_WRN("Ignoring position events of %u bytes", length);
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    const struct zmk_split_position_events_payload *payload = data;
+    size_t count = MIN((length - header_len) / sizeof(struct zmk_split_position_event),
+                       ZMK_SPLIT_POS_EVENTS_MAX);
+
+    if (zmk_split_peripheral_positions_apply_events(&slot->positions, payload, count,
+                                                    k_uptime_get(),
+                                                    queue_peripheral_position_event, slot) > 0) {
+        read_peripheral_position_state(slot);
     }
 
     return BT_GATT_ITER_CONTINUE;
@@ -416,20 +603,13 @@ int zmk_split_get_peripheral_battery_level(uint8_t source, uint8_t *level) {
     return 0;
 }
 
-K_MSGQ_DEFINE(peripheral_batt_lvl_msgq, sizeof(struct zmk_peripheral_battery_state_changed),
-              CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_QUEUE_SIZE, 4);
-
-void peripheral_batt_lvl_change_callback(struct k_work *work) {
-    struct zmk_peripheral_battery_state_changed ev;
-    while (k_msgq_get(&peripheral_batt_lvl_msgq, &ev, K_NO_WAIT) == 0) {
-        LOG_DBG("Triggering peripheral battery level change %u", ev.state_of_charge);
-        peripheral_battery_levels[ev.source] = ev.state_of_charge;
-        raise_zmk_peripheral_battery_state_changed(ev);
-    }
+static void queue_peripheral_battery_level(uint8_t source, uint8_t level) {
+    queue_peripheral_event(&(struct peripheral_event){
+        .type = ZMK_SPLIT_CENTRAL_EVENT_BATTERY,
+        .battery = {.source = source, .state_of_charge = level},
+    });
 }
 
-K_WORK_DEFINE(peripheral_batt_lvl_work, peripheral_batt_lvl_change_callback);
-
 static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
                                                        struct bt_gatt_subscribe_params *params,
                                                        const void *data, uint16_t length) {
@@ -454,10 +634,7 @@ static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
     LOG_DBG("[BATTERY LEVEL NOTIFICATION] data %p length %u", data, length);
     uint8_t battery_level = ((uint8_t *)data)[0];
     LOG_DBG("Battery level: %u", battery_level);
-    struct zmk_peripheral_battery_state_changed ev = {
-        .source = peripheral_slot_index_for_conn(conn), .state_of_charge = battery_level};
-    k_msgq_put(&peripheral_batt_lvl_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_batt_lvl_work);
+    queue_peripheral_battery_level(peripheral_slot_index_for_conn(conn), battery_level);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -493,10 +670,7 @@ static uint8_t split_central_battery_level_read_func(struct bt_conn *conn, uint8
 
     LOG_DBG("Battery level: %u", battery_level);
 
-    struct zmk_peripheral_battery_state_changed ev = {
-        .source = peripheral_slot_index_for_conn(conn), .state_of_charge = battery_level};
-    k_msgq_put(&peripheral_batt_lvl_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_batt_lvl_work);
+    queue_peripheral_battery_level(peripheral_slot_index_for_conn(conn), battery_level);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -561,6 +735,55 @@ static void update_peripherals_selected_physical_layout(struct k_work *_work) {
 K_WORK_DEFINE(update_peripherals_selected_layouts_work,
               update_peripherals_selected_physical_layout);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_PARAM_POLICY)
+
+static const struct zmk_split_conn_param_policy conn_param_policy = {
+    .active_interval = CONFIG_ZMK_SPLIT_BLE_PREF_INT,
+    .active_latency = CONFIG_ZMK_SPLIT_BLE_ACTIVE_LATENCY,
+    .idle_interval = CONFIG_ZMK_SPLIT_BLE_IDLE_INT,
+    .idle_latency = CONFIG_ZMK_SPLIT_BLE_IDLE_LATENCY,
+};
+
+// Keys pressed on any half keep the central active, so it picks the parameters for all links.
+static void update_peripherals_conn_params(struct k_work *_work) {
+    enum zmk_activity_state state = zmk_activity_get_state();
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        struct peripheral_slot *slot = &peripherals[i];
+        uint16_t interval, latency;
+        if (slot->state != PERIPHERAL_SLOT_STATE_CONNECTED ||
+            !zmk_split_conn_params_update_needed(&conn_param_policy, state, &slot->conn_params,
+                                                 &interval, &latency)) {
+            continue;
+        }
+
+        LOG_DBG("Requesting interval %d latency %d for peripheral %d", interval, latency, i);
+        int err = bt_conn_le_param_update(
+            slot->conn,
+            BT_LE_CONN_PARAM(interval, interval, latency, CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT));
+        if (err < 0) {
+            LOG_WRN("Failed to update connection parameters of peripheral %d (err %d)", i, err);
+        }
+    }
+}
+
+K_WORK_DEFINE(update_peripherals_conn_params_work, update_peripherals_conn_params);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_PARAM_POLICY)
+
+int zmk_split_bt_central_get_conn_params(uint8_t source, struct zmk_split_bt_conn_params *params) {
+    if (source >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        return -EINVAL;
+    }
+
+    if (peripherals[source].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
+        return -ENOTCONN;
+    }
+
+    *params = peripherals[source].conn_params;
+    return 0;
+}
+
 static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
                                                  const struct bt_gatt_attr *attr,
                                                  struct bt_gatt_discover_params *params) {
@@ -594,6 +817,15 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
             slot->subscribe_params.notify = split_central_notify_func;
             slot->subscribe_params.value = BT_GATT_CCC_NOTIFY;
             split_central_subscribe(conn, &slot->subscribe_params);
+        } else if (bt_uuid_cmp(chrc_uuid,
+                               BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_EVENTS_UUID)) == 0) {
+            LOG_DBG("Found position events characteristic");
+            slot->events_subscribe_params.disc_params = &slot->events_sub_discover_params;
+            slot->events_subscribe_params.end_handle = slot->discover_params.end_handle;
+            slot->events_subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
+            slot->events_subscribe_params.notify = split_central_events_notify_func;
+            slot->events_subscribe_params.value = BT_GATT_CCC_NOTIFY;
+            split_central_subscribe(conn, &slot->events_subscribe_params);
 #if ZMK_KEYMAP_HAS_SENSORS
         } else if (bt_uuid_cmp(chrc_uuid,
                                BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_SENSOR_STATE_UUID)) == 0) {
@@ -635,6 +867,18 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
             slot->discover_params.uuid = NULL;
             slot->discover_params.start_handle = attr->handle + 2;
             slot->run_behavior_handle = bt_gatt_attr_value_handle(attr);
+
+            slot->num_of_positions_read_params = (struct bt_gatt_read_params){
+                .func = split_central_num_of_positions_read_func,
+                .handle_count = 0,
+                .by_uuid = {.start_handle = attr->handle + 2,
+                            .end_handle = slot->discover_params.end_handle,
+                            .uuid = BT_UUID_NUM_OF_DIGITALS},
+            };
+            int err = bt_gatt_read(conn, &slot->num_of_positions_read_params);
+            if (err < 0) {
+                LOG_ERR("Failed to read the number of positions (err %d)", err);
+            }
         } else if (!bt_uuid_cmp(((struct bt_gatt_chrc *)attr->user_data)->uuid,
                                 BT_UUID_DECLARE_128(ZMK_SPLIT_BT_SELECT_PHYS_LAYOUT_UUID))) {
             LOG_DBG("Found select physical layout handle");
@@ -711,7 +955,9 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
         break;
     }
 
+    // Peripherals without position events run discovery to the end, which is where they would be.
     bool subscribed = slot->run_behavior_handle && slot->subscribe_params.value_handle &&
+                      slot->events_subscribe_params.value_handle &&
                       slot->selected_physical_layout_handle;
 
 #if ZMK_KEYMAP_HAS_SENSORS
@@ -965,7 +1211,19 @@ static void split_central_connected(struct bt_conn *conn, uint8_t conn_err) {
     LOG_DBG("Connected: %s", addr);
 
     confirm_peripheral_slot_conn(conn);
+
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+    if (slot != NULL) {
+        slot->conn_params.interval = info.le.interval;
+        slot->conn_params.latency = info.le.latency;
+        slot->conn_params.timeout = info.le.timeout;
+    }
+
     split_central_process_connection(conn);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_PARAM_POLICY)
+    k_work_submit(&update_peripherals_conn_params_work);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_PARAM_POLICY)
 }
 
 static void split_central_disconnected(struct bt_conn *conn, uint8_t reason) {
@@ -977,10 +1235,7 @@ static void split_central_disconnected(struct bt_conn *conn, uint8_t reason) {
     LOG_DBG("Disconnected: %s (reason %d)", addr, reason);
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
-    struct zmk_peripheral_battery_state_changed ev = {
-        .source = peripheral_slot_index_for_conn(conn), .state_of_charge = 0};
-    k_msgq_put(&peripheral_batt_lvl_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_batt_lvl_work);
+    queue_peripheral_battery_level(peripheral_slot_index_for_conn(conn), 0);
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
@@ -1016,10 +1271,68 @@ static void split_central_security_changed(struct bt_conn *conn, bt_security_t l
     k_work_submit(&update_peripherals_selected_layouts_work);
 }
 
+static void split_central_le_param_updated(struct bt_conn *conn, uint16_t interval,
+                                           uint16_t latency, uint16_t timeout) {
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+    if (slot == NULL) {
+        return;
+    }
+
+    LOG_DBG("Peripheral connection params: interval %d latency %d timeout %d", interval, latency,
+            timeout);
+
+    zmk_split_conn_params_updated(&slot->conn_params, interval, latency, timeout);
+}
+
+static void raise_peripheral_event(struct peripheral_event *ev) {
+    switch (ev->type) {
+    case ZMK_SPLIT_CENTRAL_EVENT_POSITION:
+        LOG_DBG("Trigger key position state change for %d", ev->position.position);
+        raise_zmk_position_state_changed(ev->position);
+        break;
+#if ZMK_KEYMAP_HAS_SENSORS
+    case ZMK_SPLIT_CENTRAL_EVENT_SENSOR:
+        LOG_DBG("Trigger sensor change for %d", ev->sensor.sensor_index);
+        raise_zmk_sensor_event(ev->sensor);
+        break;
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+    case ZMK_SPLIT_CENTRAL_EVENT_INPUT: {
+        struct zmk_input_event_msg *msg = &ev->input;
+        int ret = zmk_input_split_report_peripheral_event(
+            msg->reg, msg->payload.type, msg->payload.code, msg->payload.value, msg->payload.sync);
+        if (ret < 0) {
+            LOG_WRN("Failed to report peripheral event %d", ret);
+        }
+        break;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
+    case ZMK_SPLIT_CENTRAL_EVENT_BATTERY:
+        LOG_DBG("Triggering peripheral battery level change %u", ev->battery.state_of_charge);
+        peripheral_battery_levels[ev->battery.source] = ev->battery.state_of_charge;
+        raise_zmk_peripheral_battery_state_changed(ev->battery);
+        break;
+#endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
+    default:
+        break;
+    }
+}
+
+static void peripheral_event_work_callback(struct k_work *work) {
+    struct peripheral_event ev;
+
+    // Each event is copied out first, so its slot can be reused while it is raised.
+    while (zmk_split_event_ring_get(&peripheral_event_queue, &ev) == 0) {
+        raise_peripheral_event(&ev);
+    }
+}
+
 static struct bt_conn_cb conn_callbacks = {
     .connected = split_central_connected,
     .disconnected = split_central_disconnected,
     .security_changed = split_central_security_changed,
+    .le_param_updated = split_central_le_param_updated,
 };
 
 K_THREAD_STACK_DEFINE(split_central_split_run_q_stack,
@@ -1165,6 +1478,20 @@ static int zmk_split_bt_central_init(void) {
     k_work_queue_start(&split_central_split_run_q, split_central_split_run_q_stack,
                        K_THREAD_STACK_SIZEOF(split_central_split_run_q_stack),
                        CONFIG_ZMK_BLE_THREAD_PRIORITY, NULL);
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        zmk_split_peripheral_positions_init(&peripherals[i].positions,
+                                            peripherals[i].position_state,
+                                            sizeof(peripherals[i].position_state));
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_EVENT_QUEUE_DEDICATED)
+    static const struct k_work_queue_config peripheral_event_q_config = {
+        .name = "Split Central Event Queue"};
+    k_work_queue_start(&peripheral_event_q, peripheral_event_q_stack,
+                       K_THREAD_STACK_SIZEOF(peripheral_event_q_stack),
+                       CONFIG_ZMK_SPLIT_BLE_CENTRAL_EVENT_DEDICATED_THREAD_PRIORITY,
+                       &peripheral_event_q_config);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_EVENT_QUEUE_DEDICATED)
     bt_conn_cb_register(&conn_callbacks);
 
 #if IS_ENABLED(CONFIG_SETTINGS)
@@ -1181,8 +1508,16 @@ static int zmk_split_bt_central_listener_cb(const zmk_event_t *eh) {
     if (as_zmk_physical_layout_selection_changed(eh)) {
         k_work_submit(&update_peripherals_selected_layouts_work);
     }
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_PARAM_POLICY)
+    if (as_zmk_activity_state_changed(eh)) {
+        k_work_submit(&update_peripherals_conn_params_work);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_PARAM_POLICY)
     return ZMK_EV_EVENT_BUBBLE;
 }
 
 ZMK_LISTENER(zmk_split_bt_central, zmk_split_bt_central_listener_cb);
-ZMK_SUBSCRIPTION(zmk_split_bt_central, zmk_physical_layout_selection_changed);
\ No newline at end of file
+ZMK_SUBSCRIPTION(zmk_split_bt_central, zmk_physical_layout_selection_changed);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_PARAM_POLICY)
+ZMK_SUBSCRIPTION(zmk_split_bt_central, zmk_activity_state_changed);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_PARAM_POLICY)
\ No newline at end of file
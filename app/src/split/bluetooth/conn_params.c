@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zmk/split/bluetooth/conn_params.h>
+
+bool zmk_split_conn_params_update_needed(const struct zmk_split_conn_param_policy *policy,
+                                         enum zmk_activity_state state,
+                                         const struct zmk_split_bt_conn_params *current,
+                                         uint16_t *interval, uint16_t *latency) {
+    bool active = state == ZMK_ACTIVITY_ACTIVE;
+
+    *interval = active ? policy->active_interval : policy->idle_interval;
+    *latency = active ? policy->active_latency : policy->idle_latency;
+
+    // The supervision timeout is left alone, so it does not matter whether it differs.
+    return current->interval != *interval || current->latency != *latency;
+}
+
+void zmk_split_conn_params_updated(struct zmk_split_bt_conn_params *params, uint16_t interval,
+                                   uint16_t latency, uint16_t timeout) {
+    params->interval = interval;
+    params->latency = latency;
+    params->timeout = timeout;
+    params->updates++;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/bluetooth/event_ring.h>
+
+static size_t event_ring_next(const struct zmk_split_event_ring *ring, size_t index) {
+    return (index + 1) % (2 * ring->size);
+}
+
+static uint8_t *event_ring_slot(struct zmk_split_event_ring *ring, size_t index) {
+    return ring->events + (index % ring->size) * ring->event_size;
+}
+
+int zmk_split_event_ring_put(struct zmk_split_event_ring *ring, const void *event, size_t type) {
+    size_t head = atomic_get(&ring->head);
+    size_t tail = atomic_get(&ring->tail);
+    size_t used = (head + 2 * ring->size - tail) % (2 * ring->size);
+    size_t limit = type == ring->reserved_type ? ring->size : ring->size - ring->reserved;
+
+    if (used >= limit) {
+        if (type < ring->drop_types) {
+            atomic_inc(&ring->drops[type]);
+        }
+        LOG_WRN("Event ring full, dropping event of type %d", (int)type);
+        return -ENOMEM;
+    }
+
+    memcpy(event_ring_slot(ring, head), event, ring->event_size);
+    // Publishes the event to the consumer, atomic_set() is a full barrier.
+    atomic_set(&ring->head, event_ring_next(ring, head));
+    return 0;
+}
+
+int zmk_split_event_ring_get(struct zmk_split_event_ring *ring, void *event) {
+    size_t tail = atomic_get(&ring->tail);
+
+    if (tail == (size_t)atomic_get(&ring->head)) {
+        return -ENOENT;
+    }
+
+    // Copy the event out first, so its slot is only reused once the copy is done.
+    memcpy(event, event_ring_slot(ring, tail), ring->event_size);
+    atomic_set(&ring->tail, event_ring_next(ring, tail));
+    return 0;
+}
+
+uint32_t zmk_split_event_ring_get_drops(struct zmk_split_event_ring *ring, size_t type) {
+    if (type >= ring->drop_types) {
+        return 0;
+    }
+
+    return atomic_get(&ring->drops[type]);
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/bluetooth/peripheral_positions.h>
+
+// How long the smallest arrival delay of position changes is tracked for. Two windows are kept so
+// that the estimate never drops back to a single, possibly slow, sample.
+#define PERIPHERAL_CLOCK_WINDOW_MS 10000
+
+// A change that seems to have been delayed for longer than this means the peripheral restarted or
+// its clock jumped, so the estimate starts over.
+#define PERIPHERAL_CLOCK_MAX_DELAY_MS 1000
+
+int64_t zmk_split_peripheral_clock_to_uptime(struct zmk_split_peripheral_clock *clock, int64_t now,
+                                             uint16_t timestamp) {
+    // Both clocks wrap around at the same 16 bits, so the difference is the offset between them
+    // plus however long the change took to arrive.
+    uint16_t offset = (uint16_t)now - timestamp;
+
+    if (clock->windows == 0 || now - clock->window_start >= PERIPHERAL_CLOCK_WINDOW_MS) {
+        clock->window_min[1] = clock->windows == 0 ? offset : clock->window_min[0];
+        clock->window_min[0] = offset;
+        clock->window_start = now;
+        clock->windows = MIN(clock->windows + 1, 2);
+    } else if ((int16_t)(offset - clock->window_min[0]) < 0) {
+        clock->window_min[0] = offset;
+    }
+
+    uint16_t min_offset = clock->window_min[0];
+    if ((int16_t)(clock->window_min[1] - min_offset) < 0) {
+        min_offset = clock->window_min[1];
+    }
+
+    int16_t delay = (int16_t)(offset - min_offset);
+    if (delay > PERIPHERAL_CLOCK_MAX_DELAY_MS) {
+        LOG_DBG("Peripheral clock moved by %d ms, resetting", delay);
+        clock->window_min[0] = clock->window_min[1] = offset;
+        clock->window_start = now;
+        clock->windows = 1;
+        delay = 0;
+    }
+
+    return now - delay;
+}
+
+void zmk_split_peripheral_positions_init(struct zmk_split_peripheral_positions *positions,
+                                         uint8_t *state, size_t state_len) {
+    memset(state, 0, state_len);
+    *positions = (struct zmk_split_peripheral_positions){.state = state, .state_len = state_len};
+}
+
+void zmk_split_peripheral_positions_reset(struct zmk_split_peripheral_positions *positions) {
+    positions->clock = (struct zmk_split_peripheral_clock){0};
+    positions->last_timestamp = 0;
+    positions->has_event_sequence = false;
+}
+
+// Changes are still reported in the order they arrived, so keep their timestamps in that order.
+static int64_t next_timestamp(struct zmk_split_peripheral_positions *positions,
+                              int64_t timestamp) {
+    positions->last_timestamp = MAX(timestamp, positions->last_timestamp);
+    return positions->last_timestamp;
+}
+
+void zmk_split_peripheral_positions_set_state(struct zmk_split_peripheral_positions *positions,
+                                              const uint8_t *state, int64_t timestamp,
+                                              zmk_split_position_changed_cb changed,
+                                              void *user_data) {
+    timestamp = next_timestamp(positions, timestamp);
+
+    // Changes are found a word at a time.
+    for (size_t i = 0; i < positions->state_len; i += sizeof(uint32_t)) {
+        uint32_t new_state = sys_get_le32(&state[i]);
+        uint32_t changed_bits = sys_get_le32(&positions->state[i]) ^ new_state;
+        if (changed_bits == 0) {
+            continue;
+        }
+
+        sys_put_le32(new_state, &positions->state[i]);
+
+        while (changed_bits != 0) {
+            uint32_t bit = find_lsb_set(changed_bits) - 1;
+            changed_bits &= changed_bits - 1;
+
+            changed((i * 8) + bit, (new_state & BIT(bit)) != 0, timestamp, user_data);
+        }
+    }
+}
+
+uint16_t zmk_split_peripheral_positions_apply_events(
+    struct zmk_split_peripheral_positions *positions,
+    const struct zmk_split_position_events_payload *payload, size_t count, int64_t now,
+    zmk_split_position_changed_cb changed, void *user_data) {
+    uint16_t sequence = sys_le16_to_cpu(payload->sequence);
+    uint16_t batch_timestamp = sys_le16_to_cpu(payload->timestamp);
+    uint16_t lost = 0;
+
+    if (positions->has_event_sequence && sequence != positions->next_event_sequence) {
+        lost = sequence - positions->next_event_sequence;
+        LOG_WRN("Lost %u position events from the peripheral", lost);
+    }
+    positions->has_event_sequence = true;
+    positions->next_event_sequence = sequence + count;
+
+    for (size_t i = 0; i < count; i++) {
+        uint16_t value = sys_le16_to_cpu(payload->events[i].position);
+        uint32_t position = value & ZMK_SPLIT_POS_EVENT_POSITION_MASK;
+        bool pressed = value & ZMK_SPLIT_POS_EVENT_PRESSED;
+
+        if (position >= positions->state_len * 8) {
+            LOG_WRN("Ignoring event for position %d outside of the keymap", position);
+            continue;
+        }
+
+        bool was_pressed = positions->state[position / 8] & BIT(position % 8);
+        if (was_pressed == pressed) {
+            LOG_DBG("Ignoring repeated state %d for position %d", pressed, position);
+            continue;
+        }
+        WRITE_BIT(positions->state[position / 8], position % 8, pressed);
+
+        int64_t timestamp = zmk_split_peripheral_clock_to_uptime(
+            &positions->clock, now, batch_timestamp + payload->events[i].time_offset);
+
+        changed(position, pressed, next_timestamp(positions, timestamp), user_data);
+    }
+
+    return lost;
+}
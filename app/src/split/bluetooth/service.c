@@ -45,11 +45,16 @@ static void split_svc_sensor_state_ccc(const struct bt_gatt_attr *attr, uint16_t
 }
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
-#define POS_STATE_LEN 16
+#define POS_STATE_LEN ZMK_SPLIT_POS_STATE_LEN(ZMK_KEYMAP_LEN)
 
-static uint8_t num_of_positions = ZMK_KEYMAP_LEN;
+static uint16_t num_of_positions = ZMK_KEYMAP_LEN;
 static uint8_t position_state[POS_STATE_LEN];
 
+struct position_state_payload {
+    uint8_t position_state[POS_STATE_LEN];
+    uint16_t timestamp;
+} __packed;
+
 static struct zmk_split_run_behavior_payload behavior_run_payload;
 
 static ssize_t split_svc_pos_state(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
@@ -105,13 +110,26 @@ static ssize_t split_svc_run_behavior(struct bt_conn *conn, const struct bt_gatt
 
 static ssize_t split_svc_num_of_positions(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
                                           void *buf, uint16_t len, uint16_t offset) {
-    return bt_gatt_attr_read(conn, attrs, buf, len, offset, attrs->user_data, sizeof(uint8_t));
+    // Number of Digitals is a single byte, so it only grows when there are too many positions.
+    uint8_t value[sizeof(uint16_t)];
+    sys_put_le16(*(uint16_t *)attrs->user_data, value);
+
+    return bt_gatt_attr_read(conn, attrs, buf, len, offset, value,
+                             value[1] == 0 ? sizeof(uint8_t) : sizeof(value));
 }
 
 static void split_svc_pos_state_ccc(const struct bt_gatt_attr *attr, uint16_t value) {
     LOG_DBG("value %d", value);
 }
 
+// Centrals that subscribe to position events get those instead of the position state.
+static bool position_events_enabled;
+
+static void split_svc_pos_events_ccc(const struct bt_gatt_attr *attr, uint16_t value) {
+    LOG_DBG("value %d", value);
+    position_events_enabled = value == BT_GATT_CCC_NOTIFY;
+}
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
 static zmk_hid_indicators_t hid_indicators = 0;
@@ -242,20 +260,27 @@ BT_GATT_SERVICE_DEFINE(
                            BT_GATT_CHRC_WRITE | BT_GATT_CHRC_READ,
                            BT_GATT_PERM_WRITE_ENCRYPT | BT_GATT_PERM_READ_ENCRYPT,
                            split_svc_get_selected_phys_layout, split_svc_select_phys_layout,
-                           NULL), );
+                           NULL),
+    // Keep this last, it is found by its position from the end.
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_EVENTS_UUID),
+                           BT_GATT_CHRC_NOTIFY, BT_GATT_PERM_READ_ENCRYPT, NULL, NULL, NULL),
+    BT_GATT_CCC(split_svc_pos_events_ccc,
+                BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT), );
+
+#define POS_EVENTS_ATTR (&split_svc.attrs[split_svc.attr_count - 3])
 
 K_THREAD_STACK_DEFINE(service_q_stack, CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_STACK_SIZE);
 
 struct k_work_q service_work_q;
 
-K_MSGQ_DEFINE(position_state_msgq, sizeof(char[POS_STATE_LEN]),
+K_MSGQ_DEFINE(position_state_msgq, sizeof(struct position_state_payload),
               CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE, 4);
 
 void send_position_state_callback(struct k_work *work) {
-    uint8_t state[POS_STATE_LEN];
+    struct position_state_payload payload;
 
-    while (k_msgq_get(&position_state_msgq, &state, K_NO_WAIT) == 0) {
-        int err = bt_gatt_notify(NULL, &split_svc.attrs[1], &state, sizeof(state));
+    while (k_msgq_get(&position_state_msgq, &payload, K_NO_WAIT) == 0) {
+        int err = bt_gatt_notify(NULL, &split_svc.attrs[1], &payload, sizeof(payload));
         if (err) {
             LOG_DBG("Error notifying %d", err);
         }
@@ -264,15 +289,20 @@ void send_position_state_callback(struct k_work *work) {
 
 K_WORK_DEFINE(service_position_notify_work, send_position_state_callback);
 
-int send_position_state() {
-    int err = k_msgq_put(&position_state_msgq, position_state, K_MSEC(100));
+int send_position_state(int64_t timestamp) {
+    struct position_state_payload payload = {
+        .timestamp = sys_cpu_to_le16((uint16_t)timestamp),
+    };
+    memcpy(payload.position_state, position_state, sizeof(position_state));
+
+    int err = k_msgq_put(&position_state_msgq, &payload, K_MSEC(100));
     if (err) {
         switch (err) {
         case -EAGAIN: {
             LOG_WRN("Position state message queue full, popping first message and queueing again");
-            uint8_t discarded_state[POS_STATE_LEN];
-            k_msgq_get(&position_state_msgq, &discarded_state, K_NO_WAIT);
-            return send_position_state();
+            struct position_state_payload discarded_payload;
+            k_msgq_get(&position_state_msgq, &discarded_payload, K_NO_WAIT);
+            return send_position_state(timestamp);
         }
         default:
             LOG_WRN("Failed to queue position state to send (%d)", err);
@@ -285,14 +315,121 @@ int send_position_state() {
     return 0;
 }
 
-int zmk_split_bt_position_pressed(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, true);
-    return send_position_state();
+struct queued_position_event {
+    uint16_t sequence;
+    uint16_t position;
+    int64_t timestamp;
+};
+
+K_MSGQ_DEFINE(position_events_msgq, sizeof(struct queued_position_event),
+              CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE, 4);
+
+static uint16_t next_position_event_sequence;
+
+// The batch being sent. It is kept until the notification is queued, so running out of buffers
+// only delays it.
+static struct zmk_split_position_events_payload position_events_batch;
+static uint8_t position_events_batch_len;
+
+static void send_position_events_callback(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(service_position_events_work, send_position_events_callback);
+
+static bool fill_position_events_batch(void) {
+    struct queued_position_event ev;
+    int64_t batch_start = 0;
+
+    while (position_events_batch_len < ZMK_SPLIT_POS_EVENTS_MAX &&
+           k_msgq_peek(&position_events_msgq, &ev) == 0) {
+        if (position_events_batch_len == 0) {
+            batch_start = ev.timestamp;
+            position_events_batch.sequence = sys_cpu_to_le16(ev.sequence);
+            position_events_batch.timestamp = sys_cpu_to_le16((uint16_t)ev.timestamp);
+        } else if (ev.timestamp - batch_start > UINT8_MAX) {
+            break;
+        }
+
+        struct zmk_split_position_event *batched =
+            &position_events_batch.events[position_events_batch_len++];
+        batched->position = sys_cpu_to_le16(ev.position);
+        batched->time_offset = ev.timestamp - batch_start;
+        k_msgq_get(&position_events_msgq, &ev, K_NO_WAIT);
+    }
+
+    return position_events_batch_len > 0;
+}
+
+static void send_position_events_callback(struct k_work *work) {
+    if (!position_events_enabled) {
+        k_msgq_purge(&position_events_msgq);
+        position_events_batch_len = 0;
+        return;
+    }
+
+    while (position_events_batch_len > 0 || fill_position_events_batch()) {
+        int err = bt_gatt_notify(NULL, POS_EVENTS_ATTR, &position_events_batch,
+                                 offsetof(struct zmk_split_position_events_payload, events) +
+                                     position_events_batch_len *
+                                         sizeof(struct zmk_split_position_event));
+        if (err == -ENOMEM) {
+            k_work_schedule_for_queue(&service_work_q, &service_position_events_work, K_MSEC(1));
+            return;
+        }
+
+        if (err) {
+            // The central sees the gap in the sequence numbers.
+            LOG_WRN("Failed to notify %d position events (%d)", position_events_batch_len, err);
+        }
+
+        position_events_batch_len = 0;
+    }
+}
+
+static int send_position_event(uint32_t position, bool pressed, int64_t timestamp) {
+    if (position > ZMK_SPLIT_POS_EVENT_POSITION_MASK) {
+        return -EINVAL;
+    }
+
+    struct queued_position_event ev = {
+        .sequence = next_position_event_sequence++,
+        .position = position | (pressed ? ZMK_SPLIT_POS_EVENT_PRESSED : 0),
+        .timestamp = timestamp,
+    };
+
+    // Events are never replaced by later ones, so the central sees every change in order. If one
+    // can't be queued its sequence number is skipped, which the central reports.
+    int err = k_msgq_put(&position_events_msgq, &ev, K_MSEC(100));
+    if (err) {
+        LOG_WRN("Failed to queue position event to send (%d)", err);
+        return err;
+    }
+
+    k_work_schedule_for_queue(&service_work_q, &service_position_events_work, K_NO_WAIT);
+
+    return 0;
+}
+
+static int position_state_changed(uint32_t position, bool pressed, int64_t timestamp) {
+    if (position >= POS_STATE_LEN * 8) {
+        return -EINVAL;
+    }
+
+    // The position state is kept up to date either way, so centrals can read it to catch up.
+    WRITE_BIT(position_state[position / 8], position % 8, pressed);
+
+    if (position_events_enabled) {
+        return send_position_event(position, pressed, timestamp);
+    }
+
+    return send_position_state(timestamp);
+}
+
+int zmk_split_bt_position_pressed(uint32_t position, int64_t timestamp) {
+    return position_state_changed(position, true, timestamp);
 }
 
-int zmk_split_bt_position_released(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, false);
-    return send_position_state();
+int zmk_split_bt_position_released(uint32_t position, int64_t timestamp) {
+    return position_state_changed(position, false, timestamp);
 }
 
 #if ZMK_KEYMAP_HAS_SENSORS
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+#include <string.h>
+
+#include <dt-bindings/zmk/steno.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/steno_stroke.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define STENO_PACKET_MAX_LEN 6
+
+#if DT_HAS_CHOSEN(zmk_steno_uart)
+
+static const struct device *const steno_uart = DEVICE_DT_GET(DT_CHOSEN(zmk_steno_uart));
+
+#endif // DT_HAS_CHOSEN(zmk_steno_uart)
+
+#if IS_ENABLED(CONFIG_ZMK_STENO_PROTOCOL_GEMINI_PR)
+
+// GeminiPR packets are 6 bytes, with 7 keys per byte in the order of the STENO_* key numbers. The
+// high bit is only set on the first byte, so the host can find the start of a packet.
+static size_t encode_stroke(uint64_t keys, uint8_t *packet) {
+    memset(packet, 0, STENO_PACKET_MAX_LEN);
+    packet[0] = BIT(7);
+
+    for (int k = 0; k < STENO_KEYS_LEN; k++) {
+        if (keys & BIT64(k)) {
+            packet[k / 7] |= BIT(6 - (k % 7));
+        }
+    }
+
+    return STENO_PACKET_MAX_LEN;
+}
+
+#elif IS_ENABLED(CONFIG_ZMK_STENO_PROTOCOL_TX_BOLT)
+
+// TX Bolt packs the keys in four sets of six, with the set number in the top two bits of each
+// byte. Only sets with keys in them are sent, followed by a zero byte to end the stroke.
+#define TX_BOLT_KEY(set, bit) (((set) * 6) + (bit) + 1)
+
+static const uint8_t tx_bolt_keys[STENO_KEYS_LEN] = {
+    [STENO_N1] = TX_BOLT_KEY(3, 4),
+    [STENO_N2] = TX_BOLT_KEY(3, 4),
+    [STENO_N3] = TX_BOLT_KEY(3, 4),
+    [STENO_N4] = TX_BOLT_KEY(3, 4),
+    [STENO_N5] = TX_BOLT_KEY(3, 4),
+    [STENO_N6] = TX_BOLT_KEY(3, 4),
+    [STENO_S1] = TX_BOLT_KEY(0, 0),
+    [STENO_S2] = TX_BOLT_KEY(0, 0),
+    [STENO_TL] = TX_BOLT_KEY(0, 1),
+    [STENO_KL] = TX_BOLT_KEY(0, 2),
+    [STENO_PL] = TX_BOLT_KEY(0, 3),
+    [STENO_WL] = TX_BOLT_KEY(0, 4),
+    [STENO_HL] = TX_BOLT_KEY(0, 5),
+    [STENO_RL] = TX_BOLT_KEY(1, 0),
+    [STENO_A] = TX_BOLT_KEY(1, 1),
+    [STENO_O] = TX_BOLT_KEY(1, 2),
+    [STENO_ST1] = TX_BOLT_KEY(1, 3),
+    [STENO_ST2] = TX_BOLT_KEY(1, 3),
+    [STENO_ST3] = TX_BOLT_KEY(1, 3),
+    [STENO_ST4] = TX_BOLT_KEY(1, 3),
+    [STENO_E] = TX_BOLT_KEY(1, 4),
+    [STENO_U] = TX_BOLT_KEY(1, 5),
+    [STENO_FR] = TX_BOLT_KEY(2, 0),
+    [STENO_RR] = TX_BOLT_KEY(2, 1),
+    [STENO_PR] = TX_BOLT_KEY(2, 2),
+    [STENO_BR] = TX_BOLT_KEY(2, 3),
+    [STENO_LR] = TX_BOLT_KEY(2, 4),
+    [STENO_GR] = TX_BOLT_KEY(2, 5),
+    [STENO_TR] = TX_BOLT_KEY(3, 0),
+    [STENO_SR] = TX_BOLT_KEY(3, 1),
+    [STENO_DR] = TX_BOLT_KEY(3, 2),
+    [STENO_N7] = TX_BOLT_KEY(3, 4),
+    [STENO_N8] = TX_BOLT_KEY(3, 4),
+    [STENO_N9] = TX_BOLT_KEY(3, 4),
+    [STENO_NA] = TX_BOLT_KEY(3, 4),
+    [STENO_NB] = TX_BOLT_KEY(3, 4),
+    [STENO_NC] = TX_BOLT_KEY(3, 4),
+    [STENO_ZR] = TX_BOLT_KEY(3, 3),
+};
+
+static size_t encode_stroke(uint64_t keys, uint8_t *packet) {
+    uint8_t sets[4] = {0};
+
+    for (int k = 0; k < STENO_KEYS_LEN; k++) {
+        if ((keys & BIT64(k)) && tx_bolt_keys[k] > 0) {
+            uint8_t key = tx_bolt_keys[k] - 1;
+            sets[key / 6] |= BIT(key % 6);
+        }
+    }
+
+    size_t len = 0;
+    for (int set = 0; set < ARRAY_SIZE(sets); set++) {
+        if (sets[set]) {
+            packet[len++] = (set << 6) | sets[set];
+        }
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    packet[len++] = 0;
+
+    return len;
+}
+
+#endif
+
+static void log_packet(const uint8_t *packet, size_t len) {
+    char hex[STENO_PACKET_MAX_LEN * 3 + 1] = {0};
+
+    for (size_t i = 0; i < len; i++) {
+        snprintk(&hex[i * 3], 4, "%02X ", packet[i]);
+    }
+
+    LOG_DBG("packet %s", hex);
+}
+
+static int steno_stroke_listener(const zmk_event_t *eh) {
+    const struct zmk_steno_stroke *ev = as_zmk_steno_stroke(eh);
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    uint8_t packet[STENO_PACKET_MAX_LEN];
+    size_t len = encode_stroke(ev->keys, packet);
+    if (len == 0) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    log_packet(packet, len);
+
+#if DT_HAS_CHOSEN(zmk_steno_uart)
+    if (!device_is_ready(steno_uart)) {
+        LOG_WRN("Steno UART is not ready, dropping stroke");
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        uart_poll_out(steno_uart, packet[i]);
+    }
+#endif // DT_HAS_CHOSEN(zmk_steno_uart)
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(steno, steno_stroke_listener);
+ZMK_SUBSCRIPTION(steno, zmk_steno_stroke);
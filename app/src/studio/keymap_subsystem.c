@@ -27,15 +27,15 @@ static bool encode_layer_bindings(pb_ostream_t *stream, const pb_field_t *field,
     const zmk_keymap_layer_id_t layer_id = *(uint8_t *)*arg;
 
     for (int b = 0; b < ZMK_KEYMAP_LEN; b++) {
-        const struct zmk_behavior_binding *binding =
-            zmk_keymap_get_layer_binding_at_idx(layer_id, b);
+        struct zmk_behavior_binding binding;
+        int ret = zmk_keymap_read_layer_binding_at_idx(layer_id, b, &binding);
 
         zmk_keymap_BehaviorBinding bb = zmk_keymap_BehaviorBinding_init_zero;
 
-        if (binding && binding->behavior_dev) {
-            bb.behavior_id = zmk_behavior_get_local_id(binding->behavior_dev);
-            bb.param1 = binding->param1;
-            bb.param2 = binding->param2;
+        if (ret >= 0 && binding.behavior_dev) {
+            bb.behavior_id = zmk_behavior_get_local_id(binding.behavior_dev);
+            bb.param1 = binding.param1;
+            bb.param2 = binding.param2;
         }
 
         if (!pb_encode_tag_for_field(stream, field)) {
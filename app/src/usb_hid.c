@@ -22,6 +22,10 @@
 #include <zmk/hid_indicators.h>
 #endif // IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
 
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+#include <zmk/latency_probe.h>
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+
 #include <zmk/event_manager.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -30,8 +34,23 @@ static const struct device *hid_dev;
 
 static K_SEM_DEFINE(hid_sem, 1, 1);
 
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
+static void send_queued_report(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(send_queued_report_work, send_queued_report);
+
+static void in_ready_cb(const struct device *dev) {
+    k_sem_give(&hid_sem);
+    k_work_reschedule(&send_queued_report_work, K_NO_WAIT);
+}
+
+#else
+
 static void in_ready_cb(const struct device *dev) { k_sem_give(&hid_sem); }
 
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
 #define HID_GET_REPORT_TYPE_MASK 0xff00
 #define HID_GET_REPORT_ID_MASK 0x00ff
 
@@ -184,6 +203,242 @@ static const struct hid_ops ops = {
     .set_report = set_report_cb,
 };
 
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
+// How long to wait for the host to take a report before writing the next one anyway.
+#define REPORT_SENT_TIMEOUT_MS 30
+
+struct usb_queued_report {
+    // The report ID, or zero for boot protocol reports, which have none.
+    uint8_t report_id;
+    uint8_t len;
+    union {
+        struct zmk_hid_keyboard_report keyboard;
+        struct zmk_hid_consumer_report consumer;
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+        struct zmk_hid_mouse_report mouse;
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+        zmk_hid_boot_report_t boot;
+#endif // IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    } data;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    uint32_t probe_origin;
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+};
+
+// All report types share the one interrupt IN endpoint, so they share one queue too. That keeps
+// e.g. modifiers in a keyboard report ahead of the mouse click that follows them.
+K_MSGQ_DEFINE(zmk_usb_hid_report_msgq, sizeof(struct usb_queued_report),
+              CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE, 4);
+
+static int64_t report_written_at;
+static struct zmk_hid_keyboard_report_body last_sent_keyboard_report;
+static struct zmk_hid_consumer_report_body last_sent_consumer_report;
+
+// prev is the report of the same type that the host sees before report, or NULL if that is the
+// one last sent.
+static bool is_superseded(const struct usb_queued_report *prev,
+                          const struct usb_queued_report *report,
+                          const struct usb_queued_report *next) {
+    if (report->report_id != next->report_id) {
+        return false;
+    }
+
+    switch (report->report_id) {
+    case ZMK_HID_REPORT_ID_KEYBOARD:
+        return zmk_hid_keyboard_report_body_is_skippable(
+            prev != NULL ? &prev->data.keyboard.body : &last_sent_keyboard_report,
+            &report->data.keyboard.body, &next->data.keyboard.body);
+    case ZMK_HID_REPORT_ID_CONSUMER:
+        return zmk_hid_consumer_report_body_is_skippable(
+            prev != NULL ? &prev->data.consumer.body : &last_sent_consumer_report,
+            &report->data.consumer.body, &next->data.consumer.body);
+    default:
+        // Mouse movement is relative, so every mouse report has to reach the host.
+        return false;
+    }
+}
+
+// The host takes one report per polling interval. Reports are only written once it took the
+// previous one, so the endpoint always holds the latest state just before the next poll and
+// reports that are superseded while waiting can be skipped.
+static void send_queued_report(struct k_work *work) {
+    if (k_msgq_num_used_get(&zmk_usb_hid_report_msgq) == 0) {
+        return;
+    }
+
+    if (k_sem_take(&hid_sem, K_NO_WAIT) != 0) {
+        int64_t waited = k_uptime_get() - report_written_at;
+        if (waited < REPORT_SENT_TIMEOUT_MS) {
+            // in_ready_cb() reschedules this right away once the host took the report.
+            k_work_schedule(&send_queued_report_work, K_MSEC(REPORT_SENT_TIMEOUT_MS - waited));
+            return;
+        }
+
+        LOG_WRN("Host did not take the last report, writing the next one anyway");
+    }
+
+    struct usb_queued_report report;
+    if (k_msgq_get(&zmk_usb_hid_report_msgq, &report, K_NO_WAIT) != 0) {
+        k_sem_give(&hid_sem);
+        return;
+    }
+
+    struct usb_queued_report next;
+    while (k_msgq_peek(&zmk_usb_hid_report_msgq, &next) == 0 &&
+           is_superseded(NULL, &report, &next)) {
+        k_msgq_get(&zmk_usb_hid_report_msgq, &next, K_NO_WAIT);
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        if (report.probe_origin != 0) {
+            next.probe_origin = report.probe_origin;
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        report = next;
+    }
+
+    int err = hid_int_ep_write(hid_dev, (uint8_t *)&report.data, report.len, NULL);
+    if (err) {
+        LOG_ERR("FAILED TO SEND OVER USB: %d", err);
+        k_sem_give(&hid_sem);
+        k_work_reschedule(&send_queued_report_work, K_NO_WAIT);
+        return;
+    }
+
+    report_written_at = k_uptime_get();
+
+    // Reports still queued are sent by in_ready_cb() or, if the host never takes this one, here.
+    if (k_msgq_num_used_get(&zmk_usb_hid_report_msgq) > 0) {
+        k_work_schedule(&send_queued_report_work, K_MSEC(REPORT_SENT_TIMEOUT_MS));
+    }
+
+    switch (report.report_id) {
+    case ZMK_HID_REPORT_ID_KEYBOARD:
+        last_sent_keyboard_report = report.data.keyboard.body;
+        break;
+    case ZMK_HID_REPORT_ID_CONSUMER:
+        last_sent_consumer_report = report.data.consumer.body;
+        break;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    zmk_latency_probe_record(ZMK_TRANSPORT_USB, report.probe_origin);
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+}
+
+static struct usb_queued_report compacted_reports[CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE];
+
+static const struct usb_queued_report *previous_report_of_type(size_t count, uint8_t report_id) {
+    for (size_t i = count; i > 0; i--) {
+        if (compacted_reports[i - 1].report_id == report_id) {
+            return &compacted_reports[i - 1];
+        }
+    }
+
+    return NULL;
+}
+
+// Takes all queued reports into compacted_reports, leaving out the ones that a later report
+// supersedes, and returns how many are left. Like when sending, no press or release is lost.
+static size_t compact_queued_reports(void) {
+    size_t count = 0;
+    struct usb_queued_report next;
+
+    while (k_msgq_get(&zmk_usb_hid_report_msgq, &next, K_NO_WAIT) == 0) {
+        while (count > 0 &&
+               is_superseded(previous_report_of_type(count - 1, next.report_id),
+                             &compacted_reports[count - 1], &next)) {
+            count--;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+            if (compacted_reports[count].probe_origin != 0) {
+                next.probe_origin = compacted_reports[count].probe_origin;
+            }
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        }
+
+        compacted_reports[count++] = next;
+    }
+
+    return count;
+}
+
+// Folds the newest state into the last queued report if it has the same type. Keyboard and
+// consumer reports hold the full state, so only the intermediate state is lost, and mouse
+// movement is added up.
+static bool merge_into_last_report(size_t count, const struct usb_queued_report *newest) {
+    struct usb_queued_report *last = &compacted_reports[count - 1];
+    if (last->report_id != newest->report_id || last->len != newest->len) {
+        return false;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    if (newest->report_id == ZMK_HID_REPORT_ID_MOUSE) {
+        struct zmk_hid_mouse_report_body *body = &last->data.mouse.body;
+        const struct zmk_hid_mouse_report_body *next = &newest->data.mouse.body;
+
+        body->buttons = next->buttons;
+        body->d_x = CLAMP(body->d_x + next->d_x, INT16_MIN, INT16_MAX);
+        body->d_y = CLAMP(body->d_y + next->d_y, INT16_MIN, INT16_MAX);
+        body->d_scroll_y = CLAMP(body->d_scroll_y + next->d_scroll_y, INT16_MIN, INT16_MAX);
+        body->d_scroll_x = CLAMP(body->d_scroll_x + next->d_scroll_x, INT16_MIN, INT16_MAX);
+        return true;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
+    memcpy(&last->data, &newest->data, newest->len);
+    return true;
+}
+
+// Makes room for a report in the full queue without dropping the older reports, which may hold a
+// press or release the host hasn't seen yet.
+static void queue_report_when_full(const struct usb_queued_report *queued) {
+    size_t count = compact_queued_reports();
+
+    if (count < ARRAY_SIZE(compacted_reports)) {
+        compacted_reports[count++] = *queued;
+    } else if (merge_into_last_report(count, queued)) {
+        LOG_WRN("USB report queue full, merged the report into the last queued one");
+    } else {
+        LOG_WRN("USB report queue full, dropping the newest report");
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        k_msgq_put(&zmk_usb_hid_report_msgq, &compacted_reports[i], K_NO_WAIT);
+    }
+}
+
+static int queue_report(const uint8_t *report, size_t len) {
+    struct usb_queued_report queued = {
+        .report_id = report[0],
+        .len = len,
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        .probe_origin = zmk_latency_probe_get_origin(),
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    };
+
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    if (hid_protocol != HID_PROTOCOL_REPORT) {
+        queued.report_id = 0;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+
+    if (len > sizeof(queued.data)) {
+        return -EINVAL;
+    }
+
+    memcpy(&queued.data, report, len);
+
+    if (k_msgq_put(&zmk_usb_hid_report_msgq, &queued, K_NO_WAIT) != 0) {
+        queue_report_when_full(&queued);
+    }
+
+    k_work_reschedule(&send_queued_report_work, K_NO_WAIT);
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+
 static int zmk_usb_hid_send_report(const uint8_t *report, size_t len) {
     switch (zmk_usb_get_status()) {
     case USB_DC_SUSPEND:
@@ -194,6 +449,9 @@ static int zmk_usb_hid_send_report(const uint8_t *report, size_t len) {
     case USB_DC_UNKNOWN:
         return -ENODEV;
     default:
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
+        return queue_report(report, len);
+#else
         k_sem_take(&hid_sem, K_MSEC(30));
         int err = hid_int_ep_write(hid_dev, report, len, NULL);
 
@@ -202,6 +460,7 @@ static int zmk_usb_hid_send_report(const uint8_t *report, size_t len) {
         }
 
         return err;
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_PACING)
     }
 }
 
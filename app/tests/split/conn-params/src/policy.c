@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+
+#include <zmk/split/bluetooth/conn_params.h>
+
+static const struct zmk_split_conn_param_policy policy = {
+    .active_interval = 6,
+    .active_latency = 0,
+    .idle_interval = 48,
+    .idle_latency = 8,
+};
+
+static const struct zmk_split_bt_conn_params active_params = {
+    .interval = 6,
+    .latency = 0,
+    .timeout = 400,
+};
+
+static const struct zmk_split_bt_conn_params idle_params = {
+    .interval = 48,
+    .latency = 8,
+    .timeout = 400,
+};
+
+ZTEST(conn_param_policy, test_active_keyboard_switches_idle_link_to_active_params) {
+    uint16_t interval, latency;
+
+    zassert_true(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_ACTIVE, &idle_params,
+                                                     &interval, &latency));
+    zassert_equal(interval, 6);
+    zassert_equal(latency, 0);
+}
+
+ZTEST(conn_param_policy, test_idle_keyboard_switches_active_link_to_idle_params) {
+    uint16_t interval, latency;
+
+    zassert_true(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_IDLE, &active_params,
+                                                     &interval, &latency));
+    zassert_equal(interval, 48);
+    zassert_equal(latency, 8);
+}
+
+ZTEST(conn_param_policy, test_sleeping_keyboard_uses_idle_params) {
+    uint16_t interval, latency;
+
+    zassert_true(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_SLEEP, &active_params,
+                                                     &interval, &latency));
+    zassert_equal(interval, 48);
+    zassert_equal(latency, 8);
+
+    zassert_false(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_SLEEP, &idle_params,
+                                                      &interval, &latency));
+}
+
+ZTEST(conn_param_policy, test_link_already_using_the_params_is_left_alone) {
+    uint16_t interval, latency;
+
+    zassert_false(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_ACTIVE, &active_params,
+                                                      &interval, &latency));
+    zassert_false(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_IDLE, &idle_params,
+                                                      &interval, &latency));
+}
+
+ZTEST(conn_param_policy, test_link_differing_only_in_timeout_is_left_alone) {
+    struct zmk_split_bt_conn_params params = active_params;
+    uint16_t interval, latency;
+
+    params.timeout = 200;
+
+    zassert_false(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_ACTIVE, &params,
+                                                      &interval, &latency));
+}
+
+ZTEST(conn_param_policy, test_interval_or_latency_alone_differing_needs_update) {
+    struct zmk_split_bt_conn_params params = active_params;
+    uint16_t interval, latency;
+
+    // The peripheral may have been given a different interval than the one asked for.
+    params.interval = 12;
+    zassert_true(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_ACTIVE, &params,
+                                                     &interval, &latency));
+    zassert_equal(interval, 6);
+    zassert_equal(latency, 0);
+
+    params = active_params;
+    params.latency = 4;
+    zassert_true(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_ACTIVE, &params,
+                                                     &interval, &latency));
+    zassert_equal(interval, 6);
+    zassert_equal(latency, 0);
+}
+
+ZTEST(conn_param_policy, test_updates_are_recorded_and_counted) {
+    struct zmk_split_bt_conn_params params = active_params;
+    uint16_t interval, latency;
+
+    zmk_split_conn_params_updated(&params, 48, 8, 500);
+    zmk_split_conn_params_updated(&params, 6, 0, 400);
+    zmk_split_conn_params_updated(&params, 48, 8, 400);
+
+    zassert_equal(params.interval, 48);
+    zassert_equal(params.latency, 8);
+    zassert_equal(params.timeout, 400);
+    zassert_equal(params.updates, 3);
+
+    // Once the link switched, the keyboard going idle again needs no renegotiation.
+    zassert_false(zmk_split_conn_params_update_needed(&policy, ZMK_ACTIVITY_IDLE, &params,
+                                                      &interval, &latency));
+}
+
+ZTEST_SUITE(conn_param_policy, NULL, NULL, NULL, NULL, NULL);
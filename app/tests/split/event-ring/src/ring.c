@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/bluetooth/event_ring.h>
+
+#define RING_SIZE 4
+
+enum test_event_type {
+    TEST_EVENT_POSITION,
+    TEST_EVENT_BATTERY,
+    TEST_EVENT_TYPE_COUNT,
+};
+
+struct test_event {
+    enum test_event_type type;
+    uint32_t value;
+};
+
+static int put(struct zmk_split_event_ring *ring, enum test_event_type type, uint32_t value) {
+    struct test_event ev = {.type = type, .value = value};
+
+    return zmk_split_event_ring_put(ring, &ev, ev.type);
+}
+
+#define assert_get(ring, expected_type, expected_value)                                            \
+    do {                                                                                           \
+        struct test_event ev;                                                                      \
+        zassert_ok(zmk_split_event_ring_get(ring, &ev));                                           \
+        zassert_equal(ev.type, expected_type);                                                     \
+        zassert_equal(ev.value, expected_value);                                                   \
+    } while (0)
+
+#define assert_empty(ring)                                                                         \
+    do {                                                                                           \
+        struct test_event ev;                                                                      \
+        zassert_equal(zmk_split_event_ring_get(ring, &ev), -ENOENT);                               \
+    } while (0)
+
+ZTEST(event_ring, test_empty_ring_has_no_events) {
+    ZMK_SPLIT_EVENT_RING_DEFINE(ring, struct test_event, RING_SIZE, TEST_EVENT_TYPE_COUNT);
+
+    assert_empty(&ring);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_POSITION), 0);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_BATTERY), 0);
+}
+
+ZTEST(event_ring, test_events_come_out_in_order) {
+    ZMK_SPLIT_EVENT_RING_DEFINE(ring, struct test_event, RING_SIZE, TEST_EVENT_TYPE_COUNT);
+
+    zassert_ok(put(&ring, TEST_EVENT_POSITION, 1));
+    zassert_ok(put(&ring, TEST_EVENT_BATTERY, 2));
+    zassert_ok(put(&ring, TEST_EVENT_POSITION, 3));
+
+    assert_get(&ring, TEST_EVENT_POSITION, 1);
+    assert_get(&ring, TEST_EVENT_BATTERY, 2);
+    assert_get(&ring, TEST_EVENT_POSITION, 3);
+    assert_empty(&ring);
+}
+
+ZTEST(event_ring, test_full_ring_drops_new_events_and_keeps_queued_ones) {
+    ZMK_SPLIT_EVENT_RING_DEFINE(ring, struct test_event, RING_SIZE, TEST_EVENT_TYPE_COUNT);
+
+    for (uint32_t i = 0; i < RING_SIZE; i++) {
+        zassert_ok(put(&ring, TEST_EVENT_POSITION, i));
+    }
+
+    zassert_equal(put(&ring, TEST_EVENT_POSITION, 100), -ENOMEM);
+    zassert_equal(put(&ring, TEST_EVENT_BATTERY, 101), -ENOMEM);
+
+    for (uint32_t i = 0; i < RING_SIZE; i++) {
+        assert_get(&ring, TEST_EVENT_POSITION, i);
+    }
+    assert_empty(&ring);
+}
+
+ZTEST(event_ring, test_drops_are_counted_by_type) {
+    ZMK_SPLIT_EVENT_RING_DEFINE(ring, struct test_event, RING_SIZE, TEST_EVENT_TYPE_COUNT);
+
+    for (uint32_t i = 0; i < RING_SIZE; i++) {
+        zassert_ok(put(&ring, TEST_EVENT_POSITION, i));
+    }
+
+    zassert_equal(put(&ring, TEST_EVENT_POSITION, 100), -ENOMEM);
+    zassert_equal(put(&ring, TEST_EVENT_POSITION, 101), -ENOMEM);
+    zassert_equal(put(&ring, TEST_EVENT_BATTERY, 102), -ENOMEM);
+
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_POSITION), 2);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_BATTERY), 1);
+
+    // Once there is room again, events are queued and the drop counts are kept.
+    assert_get(&ring, TEST_EVENT_POSITION, 0);
+    zassert_ok(put(&ring, TEST_EVENT_BATTERY, 103));
+    zassert_equal(put(&ring, TEST_EVENT_BATTERY, 104), -ENOMEM);
+
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_POSITION), 2);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_BATTERY), 2);
+}
+
+ZTEST(event_ring, test_drops_of_unknown_types_are_not_counted) {
+    ZMK_SPLIT_EVENT_RING_DEFINE(ring, struct test_event, RING_SIZE, TEST_EVENT_TYPE_COUNT);
+
+    for (uint32_t i = 0; i < RING_SIZE; i++) {
+        zassert_ok(put(&ring, TEST_EVENT_POSITION, i));
+    }
+
+    zassert_equal(put(&ring, TEST_EVENT_TYPE_COUNT, 100), -ENOMEM);
+
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_TYPE_COUNT), 0);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_POSITION), 0);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_BATTERY), 0);
+}
+
+ZTEST(event_ring, test_indexes_wrap_around) {
+    ZMK_SPLIT_EVENT_RING_DEFINE(ring, struct test_event, RING_SIZE, TEST_EVENT_TYPE_COUNT);
+
+    // Keeps the ring partly filled while both indexes wrap around several times, at every offset.
+    uint32_t next_put = 0;
+    uint32_t next_get = 0;
+    for (int round = 0; round < 5 * RING_SIZE; round++) {
+        while (next_put - next_get < RING_SIZE) {
+            zassert_ok(put(&ring, TEST_EVENT_POSITION, next_put++));
+        }
+        zassert_equal(put(&ring, TEST_EVENT_POSITION, next_put), -ENOMEM);
+
+        for (int i = 0; i <= round % RING_SIZE; i++) {
+            assert_get(&ring, TEST_EVENT_POSITION, next_get++);
+        }
+    }
+
+    while (next_get < next_put) {
+        assert_get(&ring, TEST_EVENT_POSITION, next_get++);
+    }
+    assert_empty(&ring);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_POSITION), 5 * RING_SIZE);
+}
+
+ZTEST(event_ring, test_reserved_slots_only_take_the_reserved_type) {
+    ZMK_SPLIT_EVENT_RING_DEFINE_RESERVED(ring, struct test_event, RING_SIZE, TEST_EVENT_TYPE_COUNT,
+                                         RING_SIZE - 1, TEST_EVENT_POSITION);
+
+    zassert_ok(put(&ring, TEST_EVENT_BATTERY, 0));
+    zassert_equal(put(&ring, TEST_EVENT_BATTERY, 1), -ENOMEM);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_BATTERY), 1);
+
+    for (uint32_t i = 1; i < RING_SIZE; i++) {
+        zassert_ok(put(&ring, TEST_EVENT_POSITION, i));
+    }
+    zassert_equal(put(&ring, TEST_EVENT_POSITION, 100), -ENOMEM);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_POSITION), 1);
+
+    assert_get(&ring, TEST_EVENT_BATTERY, 0);
+    for (uint32_t i = 1; i < RING_SIZE; i++) {
+        assert_get(&ring, TEST_EVENT_POSITION, i);
+    }
+    assert_empty(&ring);
+}
+
+ZTEST(event_ring, test_other_types_leave_the_reserved_slots_free) {
+    ZMK_SPLIT_EVENT_RING_DEFINE_RESERVED(ring, struct test_event, RING_SIZE, TEST_EVENT_TYPE_COUNT,
+                                         2, TEST_EVENT_POSITION);
+
+    // Positions may take the unreserved slots too.
+    zassert_ok(put(&ring, TEST_EVENT_POSITION, 0));
+    zassert_ok(put(&ring, TEST_EVENT_BATTERY, 1));
+    zassert_equal(put(&ring, TEST_EVENT_BATTERY, 2), -ENOMEM);
+
+    zassert_ok(put(&ring, TEST_EVENT_POSITION, 3));
+    zassert_ok(put(&ring, TEST_EVENT_POSITION, 4));
+    zassert_equal(put(&ring, TEST_EVENT_POSITION, 5), -ENOMEM);
+
+    // Other types only get a slot again once no more than the reserved ones are taken.
+    assert_get(&ring, TEST_EVENT_POSITION, 0);
+    assert_get(&ring, TEST_EVENT_BATTERY, 1);
+    zassert_equal(put(&ring, TEST_EVENT_BATTERY, 6), -ENOMEM);
+    assert_get(&ring, TEST_EVENT_POSITION, 3);
+    zassert_ok(put(&ring, TEST_EVENT_BATTERY, 7));
+
+    assert_get(&ring, TEST_EVENT_POSITION, 4);
+    assert_get(&ring, TEST_EVENT_BATTERY, 7);
+    assert_empty(&ring);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_BATTERY), 2);
+    zassert_equal(zmk_split_event_ring_get_drops(&ring, TEST_EVENT_POSITION), 1);
+}
+
+ZTEST_SUITE(event_ring, NULL, NULL, NULL, NULL, NULL);
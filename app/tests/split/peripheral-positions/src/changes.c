@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+
+#include "changes.h"
+
+#define MAX_CHANGES 512
+
+struct position_change changes[MAX_CHANGES];
+size_t change_count;
+
+void reset_changes(void) { change_count = 0; }
+
+void record_change(uint32_t position, bool pressed, int64_t timestamp, void *user_data) {
+    zassert_true(change_count < MAX_CHANGES, "Too many changes");
+
+    changes[change_count++] = (struct position_change){
+        .position = position,
+        .pressed = pressed,
+        .timestamp = timestamp,
+    };
+}
+
+uint16_t apply_events(struct zmk_split_peripheral_positions *positions, uint16_t sequence,
+                      const struct zmk_split_position_event *events, size_t count) {
+    struct zmk_split_position_events_payload payload = {
+        .sequence = sys_cpu_to_le16(sequence),
+        .timestamp = sys_cpu_to_le16(1000),
+    };
+    memcpy(payload.events, events, count * sizeof(events[0]));
+
+    return zmk_split_peripheral_positions_apply_events(positions, &payload, count, 1000,
+                                                       record_change, NULL);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/types.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <zmk/split/bluetooth/peripheral_positions.h>
+
+struct position_change {
+    uint32_t position;
+    bool pressed;
+    int64_t timestamp;
+};
+
+// The changes reported since the last reset_changes(), in order.
+extern struct position_change changes[];
+extern size_t change_count;
+
+void reset_changes(void);
+
+// A zmk_split_position_changed_cb that records each change.
+void record_change(uint32_t position, bool pressed, int64_t timestamp, void *user_data);
+
+#define assert_change(idx, pos, is_pressed)                                                        \
+    do {                                                                                           \
+        zassert_true((idx) < change_count, "Change %d is missing", (idx));                         \
+        zassert_equal(changes[idx].position, (pos), "Change %d is for position %u", (idx),         \
+                      changes[idx].position);                                                      \
+        zassert_equal(changes[idx].pressed, (is_pressed), "Change %d has the wrong state", (idx)); \
+    } while (0)
+
+#define PRESS(pos) {.position = sys_cpu_to_le16((pos) | ZMK_SPLIT_POS_EVENT_PRESSED)}
+#define RELEASE(pos) {.position = sys_cpu_to_le16(pos)}
+
+// Applies a notification with the given sequence number and events, all sent at 1000 ms and
+// received right away, and records the changes.
+uint16_t apply_events(struct zmk_split_peripheral_positions *positions, uint16_t sequence,
+                      const struct zmk_split_position_event *events, size_t count);
+
+#define EVENTS(...) ((const struct zmk_split_position_event[]){__VA_ARGS__})
+#define APPLY_EVENTS(positions, sequence, ...)                                                     \
+    apply_events(positions, sequence, EVENTS(__VA_ARGS__), ARRAY_SIZE(EVENTS(__VA_ARGS__)))
+
+static inline void set_pressed(uint8_t *bitmap, uint32_t position) {
+    bitmap[position / 8] |= BIT(position % 8);
+}
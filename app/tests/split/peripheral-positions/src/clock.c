@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/bluetooth/peripheral_positions.h>
+
+// The timestamp a peripheral whose uptime is offset_ms behind the central's sends with a change
+// that happened at the given central uptime.
+static uint16_t peripheral_timestamp(int64_t happened_at, int64_t offset_ms) {
+    return (uint16_t)(happened_at - offset_ms);
+}
+
+static int64_t to_uptime(struct zmk_split_peripheral_clock *clock, int64_t happened_at,
+                         int64_t arrived_at, int64_t offset_ms) {
+    return zmk_split_peripheral_clock_to_uptime(clock, arrived_at,
+                                                peripheral_timestamp(happened_at, offset_ms));
+}
+
+ZTEST(peripheral_clock, test_first_change_is_stamped_on_arrival) {
+    struct zmk_split_peripheral_clock clock = {0};
+
+    zassert_equal(to_uptime(&clock, 4990, 5000, 1234), 5000);
+}
+
+ZTEST(peripheral_clock, test_slower_changes_keep_their_extra_delay) {
+    struct zmk_split_peripheral_clock clock = {0};
+
+    zassert_equal(to_uptime(&clock, 1000, 1003, 500), 1003);
+    zassert_equal(to_uptime(&clock, 2000, 2030, 500), 2003);
+
+    // A faster change becomes the new reference right away.
+    zassert_equal(to_uptime(&clock, 3000, 3001, 500), 3001);
+    zassert_equal(to_uptime(&clock, 4000, 4010, 500), 4001);
+}
+
+ZTEST(peripheral_clock, test_central_clock_wraps_around) {
+    struct zmk_split_peripheral_clock clock = {0};
+
+    zassert_equal(to_uptime(&clock, 65500, 65502, 100), 65502);
+    // The central's uptime passed 65536, the peripheral's didn't yet.
+    zassert_equal(to_uptime(&clock, 65600, 65610, 100), 65602);
+    zassert_equal(to_uptime(&clock, 131100, 131105, 100), 131102);
+}
+
+ZTEST(peripheral_clock, test_peripheral_clock_wraps_around) {
+    struct zmk_split_peripheral_clock clock = {0};
+
+    // The peripheral is 40 seconds ahead, so its uptime passes 65536 at central uptime 25536.
+    zassert_equal(to_uptime(&clock, 25530, 25534, -40000), 25534);
+    zassert_equal(to_uptime(&clock, 25540, 25560, -40000), 25544);
+    zassert_equal(to_uptime(&clock, 30000, 30003, -40000), 30003);
+}
+
+ZTEST(peripheral_clock, test_fastest_change_counts_for_two_windows) {
+    struct zmk_split_peripheral_clock clock = {0};
+
+    zassert_equal(to_uptime(&clock, 1000, 1000, 0), 1000);
+
+    // The next window only sees slower changes, but still remembers the fast one.
+    zassert_equal(to_uptime(&clock, 11000, 11005, 0), 11000);
+    zassert_equal(to_uptime(&clock, 15000, 15005, 0), 15000);
+
+    // Once that window is over too, the fastest change of the last two windows counts.
+    zassert_equal(to_uptime(&clock, 21000, 21005, 0), 21005);
+    zassert_equal(to_uptime(&clock, 21500, 21507, 0), 21505);
+}
+
+ZTEST(peripheral_clock, test_long_delay_resets_the_estimate) {
+    struct zmk_split_peripheral_clock clock = {0};
+
+    zassert_equal(to_uptime(&clock, 1000, 1002, 100), 1002);
+
+    // The peripheral restarted, so its changes seem to arrive 30 seconds late.
+    zassert_equal(to_uptime(&clock, 2000, 2001, 30100), 2001);
+    zassert_equal(to_uptime(&clock, 2100, 2103, 30100), 2101);
+}
+
+ZTEST_SUITE(peripheral_clock, NULL, NULL, NULL, NULL, NULL);
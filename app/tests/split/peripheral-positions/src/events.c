@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+
+#include <zmk/split/bluetooth/peripheral_positions.h>
+
+#include "changes.h"
+
+static uint8_t state[16];
+static struct zmk_split_peripheral_positions positions;
+
+static void before_each(void *fixture) {
+    zmk_split_peripheral_positions_init(&positions, state, sizeof(state));
+    reset_changes();
+}
+
+ZTEST(peripheral_position_events, test_events_in_sequence_are_applied) {
+    zassert_equal(APPLY_EVENTS(&positions, 40, PRESS(3), PRESS(9)), 0);
+    zassert_equal(APPLY_EVENTS(&positions, 42, RELEASE(3)), 0);
+
+    zassert_equal(change_count, 3);
+    assert_change(0, 3, true);
+    assert_change(1, 9, true);
+    assert_change(2, 3, false);
+}
+
+ZTEST(peripheral_position_events, test_sequence_wraps_around) {
+    zassert_equal(APPLY_EVENTS(&positions, 65534, PRESS(3), PRESS(4)), 0);
+    zassert_equal(APPLY_EVENTS(&positions, 0, RELEASE(4)), 0);
+
+    zassert_equal(change_count, 3);
+}
+
+ZTEST(peripheral_position_events, test_lost_events_are_recovered_from_the_read_state) {
+    // The peripheral pressed 3, pressed 5, pressed 7, released 5 and pressed 9, but the second
+    // notification with the presses of 5 and 7 was lost.
+    zassert_equal(APPLY_EVENTS(&positions, 0, PRESS(3)), 0);
+    zassert_equal(APPLY_EVENTS(&positions, 3, RELEASE(5), PRESS(9)), 2);
+
+    // Position 5 never seemed pressed, so its release is skipped.
+    zassert_equal(change_count, 2);
+    assert_change(0, 3, true);
+    assert_change(1, 9, true);
+
+    // The peripheral pressed 11 while its state was read.
+    uint8_t read_state[sizeof(state)] = {0};
+    set_pressed(read_state, 3);
+    set_pressed(read_state, 7);
+    set_pressed(read_state, 9);
+    set_pressed(read_state, 11);
+    zmk_split_peripheral_positions_set_state(&positions, read_state, 1010, record_change, NULL);
+
+    zassert_equal(change_count, 4);
+    assert_change(2, 7, true);
+    assert_change(3, 11, true);
+
+    // The event for 11 arrives after the read, which already covered it.
+    zassert_equal(APPLY_EVENTS(&positions, 5, PRESS(11)), 0);
+    zassert_equal(APPLY_EVENTS(&positions, 6, RELEASE(7)), 0);
+
+    zassert_equal(change_count, 5);
+    assert_change(4, 7, false);
+}
+
+ZTEST(peripheral_position_events, test_reset_forgets_the_sequence) {
+    zassert_equal(APPLY_EVENTS(&positions, 10, PRESS(3)), 0);
+
+    zmk_split_peripheral_positions_reset(&positions);
+
+    // A reconnected peripheral may start over with any sequence number.
+    zassert_equal(APPLY_EVENTS(&positions, 0, RELEASE(3)), 0);
+    zassert_equal(change_count, 2);
+}
+
+ZTEST(peripheral_position_events, test_timestamps_never_go_backwards) {
+    zassert_equal(APPLY_EVENTS(&positions, 0, PRESS(3)), 0);
+
+    uint8_t read_state[sizeof(state)] = {0};
+    set_pressed(read_state, 3);
+    set_pressed(read_state, 4);
+    zmk_split_peripheral_positions_set_state(&positions, read_state, 900, record_change, NULL);
+
+    zassert_equal(change_count, 2);
+    zassert_equal(changes[0].timestamp, 1000);
+    zassert_equal(changes[1].timestamp, 1000);
+}
+
+ZTEST_SUITE(peripheral_position_events, NULL, NULL, before_each, NULL, NULL);
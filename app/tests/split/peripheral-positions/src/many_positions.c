@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+
+#include <zmk/split/bluetooth/peripheral_positions.h>
+
+#include "changes.h"
+
+// Twice the 128 positions that fit the shortest position state.
+#define NUM_POSITIONS 256
+
+static uint8_t state[NUM_POSITIONS / 8];
+static struct zmk_split_peripheral_positions positions;
+
+static void before_each(void *fixture) {
+    zmk_split_peripheral_positions_init(&positions, state, sizeof(state));
+    reset_changes();
+}
+
+ZTEST(peripheral_many_positions, test_state_changes_are_reported_for_all_positions) {
+    uint8_t new_state[sizeof(state)] = {0};
+    set_pressed(new_state, 0);
+    set_pressed(new_state, 31);
+    set_pressed(new_state, 32);
+    set_pressed(new_state, 127);
+    set_pressed(new_state, 128);
+    set_pressed(new_state, 200);
+    set_pressed(new_state, 255);
+    zmk_split_peripheral_positions_set_state(&positions, new_state, 1000, record_change, NULL);
+
+    zassert_equal(change_count, 7);
+    assert_change(0, 0, true);
+    assert_change(1, 31, true);
+    assert_change(2, 32, true);
+    assert_change(3, 127, true);
+    assert_change(4, 128, true);
+    assert_change(5, 200, true);
+    assert_change(6, 255, true);
+
+    new_state[128 / 8] = 0;
+    zmk_split_peripheral_positions_set_state(&positions, new_state, 1000, record_change, NULL);
+
+    zassert_equal(change_count, 8);
+    assert_change(7, 128, false);
+}
+
+ZTEST(peripheral_many_positions, test_events_are_applied_for_all_positions) {
+    zassert_equal(APPLY_EVENTS(&positions, 0, PRESS(130), PRESS(255), RELEASE(130)), 0);
+
+    zassert_equal(change_count, 3);
+    assert_change(0, 130, true);
+    assert_change(1, 255, true);
+    assert_change(2, 130, false);
+    zassert_equal(state[255 / 8], BIT(255 % 8));
+}
+
+ZTEST(peripheral_many_positions, test_events_outside_the_state_are_ignored) {
+    zassert_equal(APPLY_EVENTS(&positions, 0, PRESS(256), PRESS(0x7fff), PRESS(3)), 0);
+
+    zassert_equal(change_count, 1);
+    assert_change(0, 3, true);
+}
+
+ZTEST(peripheral_many_positions, test_releasing_all_positions) {
+    zassert_equal(APPLY_EVENTS(&positions, 0, PRESS(5), PRESS(140), PRESS(250)), 0);
+
+    static const uint8_t released_state[sizeof(state)];
+    zmk_split_peripheral_positions_set_state(&positions, released_state, 1000, record_change,
+                                             NULL);
+
+    zassert_equal(change_count, 6);
+    assert_change(3, 5, false);
+    assert_change(4, 140, false);
+    assert_change(5, 250, false);
+}
+
+ZTEST_SUITE(peripheral_many_positions, NULL, NULL, before_each, NULL, NULL);